@@ -0,0 +1,403 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <kodo_rlnc_c/encoder.h>
+#include <kodo_rlnc_c/decoder.h>
+#include <kodo_rlnc_c/parallel_decoder.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/// @file kodo_rlnc_c_benchmark.cpp
+///
+/// Throughput benchmark for the encoder and decoder. Every combination of
+/// finite field, coding vector format, number of symbols and symbol size is
+/// measured, and the results are written to the standard output as JSON.
+/// The parallel decoder is compared with the decoder on the same segmented
+/// binary8 payloads for large generations.
+///
+/// Usage: kodo_rlnc_c_benchmark [iterations]
+
+using clock_type = std::chrono::steady_clock;
+
+struct field_info
+{
+    int32_t id;
+    const char* name;
+};
+
+struct format_info
+{
+    int32_t id;
+    const char* name;
+};
+
+struct result
+{
+    double encode_megabytes_per_second;
+    double decode_megabytes_per_second;
+    std::vector<double> encode_latency_ns;
+    std::vector<double> decode_latency_ns;
+    uint64_t payloads;
+    uint64_t linearly_dependent;
+};
+
+struct parallel_result
+{
+    double decoder_megabytes_per_second;
+    double parallel_decoder_megabytes_per_second;
+    uint32_t threads;
+};
+
+static double elapsed_ns(
+    clock_type::time_point start, clock_type::time_point stop)
+{
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+static double percentile(std::vector<double>& samples, double p)
+{
+    if (samples.empty())
+        return 0.0;
+
+    std::size_t index = static_cast<std::size_t>(p * (samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+static result run(int32_t field, int32_t format, uint32_t symbols,
+                  uint32_t symbol_size, uint32_t iterations)
+{
+    krlnc_encoder_t encoder = krlnc_create_encoder(field, symbols, symbol_size);
+    krlnc_decoder_t decoder = krlnc_create_decoder(field, symbols, symbol_size);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+
+    std::vector<uint8_t> payload(krlnc_encoder_max_payload_size(encoder));
+
+    result r = result();
+    double encode_ns = 0.0;
+    double decode_ns = 0.0;
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        krlnc_reset_encoder(encoder);
+        krlnc_reset_decoder(decoder);
+
+        // Every iteration must decode the data again to pass the check
+        std::fill(data_out.begin(), data_out.end(), 0);
+
+        krlnc_encoder_set_coding_vector_format(encoder, format);
+        krlnc_encoder_set_systematic_off(encoder);
+        krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+        krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+        while (!krlnc_decoder_is_complete(decoder))
+        {
+            auto start = clock_type::now();
+            krlnc_encoder_produce_payload(encoder, payload.data());
+            auto stop = clock_type::now();
+
+            double ns = elapsed_ns(start, stop);
+            r.encode_latency_ns.push_back(ns);
+            encode_ns += ns;
+
+            uint32_t rank = krlnc_decoder_rank(decoder);
+
+            start = clock_type::now();
+            krlnc_decoder_consume_payload(decoder, payload.data());
+            stop = clock_type::now();
+
+            ns = elapsed_ns(start, stop);
+            r.decode_latency_ns.push_back(ns);
+            decode_ns += ns;
+
+            ++r.payloads;
+            if (krlnc_decoder_rank(decoder) == rank)
+                ++r.linearly_dependent;
+        }
+
+        if (data_in != data_out)
+        {
+            fprintf(stderr, "Decoding failed: field %d, format %d, "
+                    "symbols %u, symbol_size %u\n",
+                    field, format, symbols, symbol_size);
+            exit(1);
+        }
+    }
+
+    double megabytes = static_cast<double>(data_in.size()) * iterations / 1e6;
+    r.encode_megabytes_per_second = megabytes / (encode_ns / 1e9);
+    r.decode_megabytes_per_second = megabytes / (decode_ns / 1e9);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+
+    return r;
+}
+
+// Decode the payloads with a decode function until the decoding is complete.
+// The payloads may be changed while they are consumed, so each one is
+// copied first. Return the time spent in the decode function.
+template<class Consume, class IsComplete>
+static double decode_payloads(const std::vector<uint8_t>& payloads,
+                              const std::vector<uint32_t>& sizes,
+                              uint32_t stride, Consume consume,
+                              IsComplete is_complete)
+{
+    std::vector<uint8_t> payload(stride);
+    double ns = 0.0;
+
+    for (uint32_t i = 0; i < sizes.size() && !is_complete(); ++i)
+    {
+        std::copy_n(payloads.begin() + uint64_t{i} * stride, sizes[i],
+                    payload.begin());
+
+        auto start = clock_type::now();
+        consume(payload.data(), sizes[i]);
+        ns += elapsed_ns(start, clock_type::now());
+    }
+
+    return ns;
+}
+
+static parallel_result run_parallel(uint32_t symbols, uint32_t symbol_size,
+                                    uint32_t iterations)
+{
+    krlnc_encoder_t encoder =
+        krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    krlnc_decoder_t decoder =
+        krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+    krlnc_parallel_decoder_t parallel =
+        krlnc_create_parallel_decoder(symbols, symbol_size, 0);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::vector<uint8_t> data_out(data_in.size());
+    std::generate(data_in.begin(), data_in.end(), rand);
+
+    // A few extra payloads make up for the linearly dependent ones
+    uint32_t count = symbols + 16;
+    uint32_t stride = krlnc_decoder_max_segmented_payload_size(decoder);
+    std::vector<uint8_t> payloads(uint64_t{count} * stride);
+    std::vector<uint32_t> sizes(count);
+
+    parallel_result r = parallel_result();
+    r.threads = krlnc_parallel_decoder_threads(parallel);
+    double decoder_ns = 0.0;
+    double parallel_ns = 0.0;
+
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        krlnc_reset_encoder(encoder);
+        krlnc_encoder_set_systematic_off(encoder);
+        krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+        for (uint32_t j = 0; j < count; ++j)
+        {
+            krlnc_payload_segments segments;
+            sizes[j] =
+                krlnc_encoder_produce_payload_segments(encoder, &segments);
+
+            uint8_t* payload = payloads.data() + uint64_t{j} * stride;
+            std::copy_n(segments.header, segments.header_size, payload);
+            std::copy_n(segments.symbol, segments.symbol_size,
+                        payload + segments.header_size);
+        }
+
+        krlnc_reset_decoder(decoder);
+        std::fill(data_out.begin(), data_out.end(), 0);
+        krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+        decoder_ns += decode_payloads(payloads, sizes, stride,
+            [&](uint8_t* payload, uint32_t size)
+            {
+                krlnc_decoder_consume_segmented_payload(
+                    decoder, payload, size);
+            },
+            [&] { return krlnc_decoder_is_complete(decoder) != 0; });
+
+        bool decoded = data_in == data_out;
+
+        krlnc_reset_parallel_decoder(parallel);
+        std::fill(data_out.begin(), data_out.end(), 0);
+        krlnc_parallel_decoder_set_symbols_storage(parallel, data_out.data());
+
+        parallel_ns += decode_payloads(payloads, sizes, stride,
+            [&](uint8_t* payload, uint32_t size)
+            {
+                krlnc_parallel_decoder_consume_segmented_payload(
+                    parallel, payload, size);
+            },
+            [&] { return krlnc_parallel_decoder_is_complete(parallel) != 0; });
+
+        if (!decoded || data_in != data_out)
+        {
+            fprintf(stderr, "Parallel comparison failed: symbols %u, "
+                    "symbol_size %u\n", symbols, symbol_size);
+            exit(1);
+        }
+    }
+
+    double megabytes = static_cast<double>(data_in.size()) * iterations / 1e6;
+    r.decoder_megabytes_per_second = megabytes / (decoder_ns / 1e9);
+    r.parallel_decoder_megabytes_per_second =
+        megabytes / (parallel_ns / 1e9);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+    krlnc_delete_parallel_decoder(parallel);
+
+    return r;
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t iterations = 10;
+
+    if (argc == 2)
+    {
+        char* end = nullptr;
+        unsigned long long value = strtoull(argv[1], &end, 10);
+
+        // Zero iterations would give a throughput of 0 / 0
+        if (end == argv[1] || *end != '\0' || value == 0 ||
+            value > UINT32_MAX)
+        {
+            iterations = 0;
+        }
+        else
+        {
+            iterations = static_cast<uint32_t>(value);
+        }
+    }
+
+    if (argc > 2 || iterations == 0)
+    {
+        printf("usage : %s [iterations]\n", argv[0]);
+        printf("iterations must be a positive integer\n");
+        return 1;
+    }
+
+    srand(42);
+
+    const field_info fields[] =
+    {
+        { krlnc_binary, "binary" },
+        { krlnc_binary4, "binary4" },
+        { krlnc_binary8, "binary8" },
+        { krlnc_binary16, "binary16" }
+    };
+
+    const format_info formats[] =
+    {
+        { krlnc_full_vector, "full_vector" },
+        { krlnc_seed, "seed" },
+        { krlnc_sparse_seed, "sparse_seed" }
+    };
+
+    const uint32_t symbols_grid[] = { 16, 64, 256 };
+    const uint32_t symbol_size_grid[] = { 160, 1400, 16000 };
+
+    bool first = true;
+
+    printf("{\n");
+    printf("  \"benchmark\": \"kodo_rlnc_c_benchmark\",\n");
+    printf("  \"iterations\": %u,\n", iterations);
+    printf("  \"results\": [");
+
+    for (const field_info& field : fields)
+    {
+        for (const format_info& format : formats)
+        {
+            for (uint32_t symbols : symbols_grid)
+            {
+                for (uint32_t symbol_size : symbol_size_grid)
+                {
+                    result r = run(field.id, format.id, symbols, symbol_size,
+                                   iterations);
+
+                    double overhead =
+                        static_cast<double>(r.linearly_dependent) /
+                        (static_cast<double>(symbols) * iterations);
+
+                    printf("%s\n    {\n", first ? "" : ",");
+                    printf("      \"field\": \"%s\",\n", field.name);
+                    printf("      \"coding_vector_format\": \"%s\",\n",
+                           format.name);
+                    printf("      \"symbols\": %u,\n", symbols);
+                    printf("      \"symbol_size\": %u,\n", symbol_size);
+                    printf("      \"encode_megabytes_per_second\": %.3f,\n",
+                           r.encode_megabytes_per_second);
+                    printf("      \"decode_megabytes_per_second\": %.3f,\n",
+                           r.decode_megabytes_per_second);
+                    printf("      \"encode_latency_ns\": "
+                           "{ \"p50\": %.0f, \"p90\": %.0f, \"p99\": %.0f },\n",
+                           percentile(r.encode_latency_ns, 0.50),
+                           percentile(r.encode_latency_ns, 0.90),
+                           percentile(r.encode_latency_ns, 0.99));
+                    printf("      \"decode_latency_ns\": "
+                           "{ \"p50\": %.0f, \"p90\": %.0f, \"p99\": %.0f },\n",
+                           percentile(r.decode_latency_ns, 0.50),
+                           percentile(r.decode_latency_ns, 0.90),
+                           percentile(r.decode_latency_ns, 0.99));
+                    printf("      \"payloads\": %llu,\n",
+                           static_cast<unsigned long long>(r.payloads));
+                    printf("      \"linearly_dependent\": %llu,\n",
+                           static_cast<unsigned long long>(
+                               r.linearly_dependent));
+                    printf("      \"linear_dependency_overhead\": %.5f\n",
+                           overhead);
+                    printf("    }");
+                    fflush(stdout);
+
+                    first = false;
+                }
+            }
+        }
+    }
+
+    printf("\n  ],\n");
+    printf("  \"parallel_decoder_results\": [");
+
+    const uint32_t parallel_symbols_grid[] = { 256, 1024 };
+    const uint32_t parallel_symbol_size_grid[] = { 1400, 16000 };
+
+    first = true;
+
+    for (uint32_t symbols : parallel_symbols_grid)
+    {
+        for (uint32_t symbol_size : parallel_symbol_size_grid)
+        {
+            parallel_result r = run_parallel(symbols, symbol_size, iterations);
+
+            printf("%s\n    {\n", first ? "" : ",");
+            printf("      \"field\": \"binary8\",\n");
+            printf("      \"symbols\": %u,\n", symbols);
+            printf("      \"symbol_size\": %u,\n", symbol_size);
+            printf("      \"threads\": %u,\n", r.threads);
+            printf("      \"decoder_megabytes_per_second\": %.3f,\n",
+                   r.decoder_megabytes_per_second);
+            printf("      \"parallel_decoder_megabytes_per_second\": %.3f,\n",
+                   r.parallel_decoder_megabytes_per_second);
+            printf("      \"speedup\": %.3f\n",
+                   r.parallel_decoder_megabytes_per_second /
+                   r.decoder_megabytes_per_second);
+            printf("    }");
+            fflush(stdout);
+
+            first = false;
+        }
+    }
+
+    printf("\n  ]\n}\n");
+
+    return 0;
+}
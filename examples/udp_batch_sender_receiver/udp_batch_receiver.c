@@ -0,0 +1,267 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF EVALUATION LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+// recvmmsg() is a GNU extension
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <kodo_rlnc_c/decoder.h>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+
+// The maximum number of packets received with a single recvmmsg() call
+#define BATCH_SIZE 64
+
+// Every packet starts with the generation number in network byte order
+#define HEADER_SIZE 4
+
+static double now_seconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// A datagram that did not fit in its buffer is truncated by the kernel,
+// and the decoder cannot tell a cut off payload from a valid one
+static int is_complete_packet(const struct mmsghdr* message)
+{
+    return (message->msg_hdr.msg_flags & MSG_TRUNC) == 0 &&
+           message->msg_len >= HEADER_SIZE;
+}
+
+int main(int argc, char* argv[])
+{
+    // Variables needed for the network / socket usage
+    int32_t socket_descriptor = 0;
+    int32_t return_code = 0;
+    uint32_t i = 0;
+    int buffer_size = 8 * 1024 * 1024;
+    struct sockaddr_in local_address;
+    struct timeval timeout;
+
+    // Variables needed for the coding
+    uint32_t symbols = 32;
+    uint32_t symbol_size = 1024;
+    int32_t finite_field = krlnc_binary8;
+
+    uint32_t generations = 0;
+    uint32_t generations_decoded = 0;
+
+    // The generation that is currently being decoded
+    uint32_t generation = 0;
+    uint8_t decoding = 0;
+
+    krlnc_decoder_t decoder = NULL;
+
+    // The batch of packets received with a single system call. Each packet
+    // is stored at a multiple of the stride.
+    uint32_t stride = 0;
+    uint8_t* packets = NULL;
+    struct iovec iovecs[BATCH_SIZE];
+    struct mmsghdr messages[BATCH_SIZE];
+
+    uint32_t block_size = 0;
+    uint8_t* data_out = NULL;
+
+    uint64_t packets_received = 0;
+    uint64_t packets_discarded = 0;
+    double start = 0;
+    double end = 0;
+
+    if (argc != 4)
+    {
+        printf("usage : %s <port> <symbols> <generations>\n", argv[0]);
+        exit(1);
+    }
+
+    symbols = atoi(argv[2]);
+    generations = atoi(argv[3]);
+
+    // Socket creation
+    socket_descriptor = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_descriptor < 0)
+    {
+        printf("%s: cannot open socket \n", argv[0]);
+        exit(1);
+    }
+
+    // A large receive buffer absorbs the bursts of the sender
+    setsockopt(socket_descriptor, SOL_SOCKET, SO_RCVBUF,
+               &buffer_size, sizeof(buffer_size));
+
+    // Stop waiting if the sender has been silent for a second
+    timeout.tv_sec = 1;
+    timeout.tv_usec = 0;
+    setsockopt(socket_descriptor, SOL_SOCKET, SO_RCVTIMEO,
+               &timeout, sizeof(timeout));
+
+    // Bind local server port
+    memset(&local_address, 0, sizeof(local_address));
+    local_address.sin_family = AF_INET;
+    local_address.sin_addr.s_addr = htonl(INADDR_ANY);
+    local_address.sin_port = htons(atoi(argv[1]));
+    return_code = bind(socket_descriptor, (struct sockaddr*) &local_address,
+                       sizeof(local_address));
+
+    if (return_code < 0)
+    {
+        printf("%s: cannot bind port number %d \n", argv[0], atoi(argv[1]));
+        exit(1);
+    }
+
+    decoder = krlnc_create_decoder(finite_field, symbols, symbol_size);
+
+    // Create the batch buffer
+    stride = HEADER_SIZE + krlnc_decoder_max_payload_size(decoder);
+    packets = (uint8_t*) malloc(stride * BATCH_SIZE);
+
+    // Every generation is decoded into the same buffer. In a real
+    // application the data would be copied out or handed over when a
+    // generation is complete.
+    block_size = krlnc_decoder_block_size(decoder);
+    data_out = (uint8_t*) malloc(block_size);
+    krlnc_decoder_set_symbols_storage(decoder, data_out);
+
+    memset(messages, 0, sizeof(messages));
+    for (i = 0; i < BATCH_SIZE; ++i)
+    {
+        iovecs[i].iov_base = packets + i * stride;
+        iovecs[i].iov_len = stride;
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    printf("%s: waiting for data on UDP port %u\n", argv[0], atoi(argv[1]));
+
+    // Receiver loop
+    while (generations_decoded < generations)
+    {
+        uint32_t received = 0;
+        uint32_t first = 0;
+
+        // Block until at least one packet is available, and then take all
+        // the packets that are waiting, up to a full batch
+        return_code = recvmmsg(socket_descriptor, messages, BATCH_SIZE,
+                               MSG_WAITFORONE, NULL);
+
+        if (return_code < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                // The sender is done, or the remaining packets were lost
+                if (packets_received > 0)
+                    break;
+
+                continue;
+            }
+
+            printf("%s: recvmmsg error %d\n", argv[0], errno);
+            continue;
+        }
+
+        if (packets_received == 0)
+            start = now_seconds();
+
+        received = return_code;
+        packets_received += received;
+
+        // Consume the packets in runs that belong to the same generation,
+        // so every run is passed to the decoder with a single call
+        while (first < received)
+        {
+            uint32_t header = 0;
+            uint32_t packet_generation = 0;
+            uint32_t last = first + 1;
+
+            if (!is_complete_packet(&messages[first]))
+            {
+                ++packets_discarded;
+                ++first;
+                continue;
+            }
+
+            memcpy(&header, packets + first * stride, HEADER_SIZE);
+            packet_generation = ntohl(header);
+
+            for (; last < received; ++last)
+            {
+                if (!is_complete_packet(&messages[last]))
+                    break;
+
+                memcpy(&header, packets + last * stride, HEADER_SIZE);
+                if (ntohl(header) != packet_generation)
+                    break;
+            }
+
+            // Start decoding a new generation. Packets from older
+            // generations arrive too late and are dropped.
+            if (!decoding || packet_generation > generation)
+            {
+                krlnc_reset_decoder(decoder);
+                krlnc_decoder_set_symbols_storage(decoder, data_out);
+                generation = packet_generation;
+                decoding = 1;
+            }
+
+            if (packet_generation == generation &&
+                !krlnc_decoder_is_complete(decoder))
+            {
+                krlnc_decoder_consume_payloads(
+                    decoder, packets + first * stride + HEADER_SIZE,
+                    last - first, stride);
+
+                if (krlnc_decoder_is_complete(decoder))
+                {
+                    ++generations_decoded;
+                    end = now_seconds();
+                }
+            }
+
+            first = last;
+        }
+    }
+
+    printf("Received %llu packets, decoded %u of %u generations\n",
+           (unsigned long long) packets_received, generations_decoded,
+           generations);
+
+    if (packets_discarded > 0)
+        printf("Discarded %llu truncated packets\n",
+               (unsigned long long) packets_discarded);
+
+    if (generations_decoded > 0 && end > start)
+    {
+        double elapsed = end - start;
+        double goodput = (double) generations_decoded * block_size * 8;
+
+        printf("Packet rate: %.0f packets/s\n", packets_received / elapsed);
+        printf("Goodput: %.3f Gbit/s\n", goodput / elapsed / 1e9);
+    }
+
+    // Cleanup
+    close(socket_descriptor);
+
+    free(data_out);
+    free(packets);
+
+    krlnc_delete_decoder(decoder);
+
+    return 0;
+}
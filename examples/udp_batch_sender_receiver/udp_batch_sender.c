@@ -0,0 +1,278 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF EVALUATION LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+// sendmmsg() is a GNU extension
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <kodo_rlnc_c/encoder.h>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+// The maximum number of packets passed to a single sendmmsg() call
+#define BATCH_SIZE 64
+
+// Every packet starts with the generation number in network byte order,
+// so the receiver knows when to start decoding a new generation
+#define HEADER_SIZE 4
+
+static double now_seconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// A token bucket that limits the sending rate. The bucket is refilled with
+// rate bytes per second and holds at most one batch worth of tokens, which
+// allows a batch to be sent back-to-back without exceeding the rate on
+// average.
+typedef struct
+{
+    double rate;
+    double capacity;
+    double tokens;
+    double last;
+}
+token_bucket;
+
+static void token_bucket_wait(token_bucket* bucket, uint32_t bytes)
+{
+    // A rate of zero means that the sending rate is not limited
+    if (bucket->rate == 0)
+        return;
+
+    while (1)
+    {
+        double now = now_seconds();
+        bucket->tokens += (now - bucket->last) * bucket->rate;
+        bucket->last = now;
+
+        if (bucket->tokens > bucket->capacity)
+            bucket->tokens = bucket->capacity;
+
+        if (bucket->tokens >= bytes)
+            break;
+
+        // Sleep until enough tokens are available
+        double missing = (bytes - bucket->tokens) / bucket->rate;
+        struct timespec delay;
+        delay.tv_sec = (time_t) missing;
+        delay.tv_nsec = (long) ((missing - delay.tv_sec) * 1e9);
+        nanosleep(&delay, NULL);
+    }
+
+    bucket->tokens -= bytes;
+}
+
+int main(int argc, char* argv[])
+{
+    // Variables needed for the network / socket usage
+    int32_t socket_descriptor;
+    int32_t return_code;
+    uint32_t i;
+    int buffer_size = 8 * 1024 * 1024;
+
+    struct sockaddr_in remote_address;
+    struct hostent* host;
+
+    // Variables needed for the coding
+    uint32_t symbols = 32;
+    uint32_t symbol_size = 1024;
+    int32_t finite_field = krlnc_binary8;
+
+    uint32_t generations = 0;
+    uint32_t extra_payloads = 0;
+    uint32_t generation = 0;
+
+    krlnc_encoder_t encoder = NULL;
+
+    // The batch of packets that is produced by the encoder and sent with a
+    // single system call. Each packet is stored at a multiple of the stride.
+    uint32_t stride = 0;
+    uint8_t* packets = NULL;
+    uint32_t sizes[BATCH_SIZE];
+    struct iovec iovecs[BATCH_SIZE];
+    struct mmsghdr messages[BATCH_SIZE];
+
+    // The data to be encoded
+    uint32_t block_size = 0;
+    uint8_t* data_in = NULL;
+
+    token_bucket bucket;
+
+    uint64_t packets_sent = 0;
+    uint64_t bytes_sent = 0;
+    double start = 0;
+    double elapsed = 0;
+
+    // Check command line args
+    if (argc != 7)
+    {
+        printf("usage : %s <server> <port> <symbols> <generations> "
+               "<rate_mbit> <extra_payloads>\n", argv[0]);
+
+        exit(1);
+    }
+
+    // Get server IP address (no check if input is IP address or DNS name)
+    host = gethostbyname(argv[1]);
+    if (host == NULL)
+    {
+        printf("%s: unknown host '%s' \n", argv[0], argv[1]);
+        exit(1);
+    }
+
+    printf("Sending data to '%s:%d' (IP: %s) \n", host->h_name,
+           atoi(argv[2]), inet_ntoa(*(struct in_addr*)host->h_addr_list[0]));
+
+    memset(&remote_address, 0, sizeof(remote_address));
+    remote_address.sin_family = host->h_addrtype;
+    memcpy((char*) &remote_address.sin_addr.s_addr,
+           host->h_addr_list[0], host->h_length);
+    remote_address.sin_port = htons(atoi(argv[2]));
+
+    symbols = atoi(argv[3]);
+    generations = atoi(argv[4]);
+    extra_payloads = atoi(argv[6]);
+
+    // The rate is given in Mbit/s, the token bucket counts bytes
+    memset(&bucket, 0, sizeof(bucket));
+    bucket.rate = atof(argv[5]) * 1e6 / 8;
+    bucket.last = now_seconds();
+
+    // Socket creation
+    socket_descriptor = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_descriptor < 0)
+    {
+        printf("%s: cannot open socket \n", argv[0]);
+        exit(1);
+    }
+
+    // A large send buffer allows a whole batch to be queued at once
+    setsockopt(socket_descriptor, SOL_SOCKET, SO_SNDBUF,
+               &buffer_size, sizeof(buffer_size));
+
+    // Connect the socket, so the messages do not need a destination address
+    return_code = connect(socket_descriptor,
+                          (struct sockaddr*) &remote_address,
+                          sizeof(remote_address));
+
+    if (return_code < 0)
+    {
+        printf("%s: cannot connect socket\n", argv[0]);
+        exit(1);
+    }
+
+    // Create the encoder
+    encoder = krlnc_create_encoder(finite_field, symbols, symbol_size);
+
+    // Create the batch buffer, each packet has room for the header and the
+    // largest payload
+    stride = HEADER_SIZE + krlnc_encoder_max_payload_size(encoder);
+    packets = (uint8_t*) malloc(stride * BATCH_SIZE);
+
+    // The token bucket may hold a full batch of packets
+    bucket.capacity = stride * BATCH_SIZE;
+    bucket.tokens = bucket.capacity;
+
+    // Create some data to encode, the same data is sent in every generation
+    block_size = krlnc_encoder_block_size(encoder);
+    data_in = (uint8_t*) malloc(block_size);
+
+    for (i = 0; i < block_size; ++i)
+        data_in[i] = rand() % 256;
+
+    memset(messages, 0, sizeof(messages));
+    for (i = 0; i < BATCH_SIZE; ++i)
+    {
+        iovecs[i].iov_base = packets + i * stride;
+        messages[i].msg_hdr.msg_iov = &iovecs[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    start = now_seconds();
+
+    for (generation = 0; generation < generations; ++generation)
+    {
+        uint32_t remaining = symbols + extra_payloads;
+        uint32_t header = htonl(generation);
+
+        krlnc_reset_encoder(encoder);
+        krlnc_encoder_set_symbols_storage(encoder, data_in);
+
+        while (remaining > 0)
+        {
+            uint32_t count = remaining < BATCH_SIZE ? remaining : BATCH_SIZE;
+            uint32_t batch_bytes = 0;
+            uint32_t sent = 0;
+
+            // Produce the whole batch with one call. The payloads are
+            // written after the header of each packet.
+            batch_bytes = krlnc_encoder_produce_payloads(
+                encoder, packets + HEADER_SIZE, count, stride, sizes);
+            batch_bytes += count * HEADER_SIZE;
+
+            for (i = 0; i < count; ++i)
+            {
+                memcpy(packets + i * stride, &header, HEADER_SIZE);
+                iovecs[i].iov_len = HEADER_SIZE + sizes[i];
+            }
+
+            token_bucket_wait(&bucket, batch_bytes);
+
+            // sendmmsg() may send fewer messages than requested
+            while (sent < count)
+            {
+                return_code = sendmmsg(socket_descriptor, messages + sent,
+                                       count - sent, 0);
+
+                if (return_code < 0)
+                {
+                    printf("%s: cannot send data\n", argv[0]);
+                    close(socket_descriptor);
+                    exit(1);
+                }
+
+                sent += return_code;
+            }
+
+            packets_sent += count;
+            bytes_sent += batch_bytes;
+            remaining -= count;
+        }
+    }
+
+    elapsed = now_seconds() - start;
+
+    printf("Sent %llu packets (%u generations) in %.3f seconds\n",
+           (unsigned long long) packets_sent, generations, elapsed);
+    printf("Packet rate: %.0f packets/s\n", packets_sent / elapsed);
+    printf("Throughput: %.3f Gbit/s\n", bytes_sent * 8 / elapsed / 1e9);
+
+    // Clean up
+    close(socket_descriptor);
+
+    free(data_in);
+    free(packets);
+
+    krlnc_delete_encoder(encoder);
+
+    return 0;
+}
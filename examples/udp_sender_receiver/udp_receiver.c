@@ -51,6 +51,7 @@ int main(int argc, char* argv[])
     int32_t finite_field = krlnc_binary8;
 
     krlnc_decoder_t decoder = NULL;
+    krlnc_decoder_consume_status status;
 
     // The buffer used to receive incoming packets
     uint32_t payload_size = 0;
@@ -154,9 +155,10 @@ int main(int argc, char* argv[])
         ++rx_packets;
 
         // Packet got through - pass that packet to the decoder
-        krlnc_decoder_consume_payload(decoder, payload);
+        krlnc_decoder_consume_payload_with_status(decoder, payload, &status);
 
-        if (krlnc_decoder_is_partially_complete(decoder))
+        // Only look for the decoded symbols if this packet decoded any
+        if (status.symbols_decoded > 0)
         {
             uint32_t i = 0;
             for (; i < symbols; ++i)
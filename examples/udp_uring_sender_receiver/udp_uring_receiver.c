@@ -0,0 +1,272 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF EVALUATION LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <kodo_rlnc_c/decoder.h>
+
+#include <liburing.h>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+
+// The number of receive operations that are kept in flight
+#define QUEUE_DEPTH 256
+
+// Every packet starts with the generation number in network byte order
+#define HEADER_SIZE 4
+
+static double now_seconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Queue a receive operation that reads the next packet into a slot of the
+// registered buffer
+static void receive_into_slot(struct io_uring* ring, int32_t socket_descriptor,
+                              uint8_t* packets, uint32_t stride, uint32_t slot)
+{
+    struct io_uring_sqe* sqe = io_uring_get_sqe(ring);
+    assert(sqe != NULL);
+
+    io_uring_prep_read_fixed(sqe, socket_descriptor, packets + slot * stride,
+                             stride, 0, 0);
+    io_uring_sqe_set_data(sqe, (void*) (uintptr_t) slot);
+}
+
+int main(int argc, char* argv[])
+{
+    // Variables needed for the network / socket usage
+    int32_t socket_descriptor = 0;
+    int32_t return_code = 0;
+    uint32_t i = 0;
+    int buffer_size = 8 * 1024 * 1024;
+    struct sockaddr_in local_address;
+
+    struct io_uring ring;
+    struct io_uring_cqe* cqe = NULL;
+    struct iovec buffer;
+    struct __kernel_timespec timeout;
+
+    // Variables needed for the coding
+    uint32_t symbols = 32;
+    uint32_t symbol_size = 1024;
+    int32_t finite_field = krlnc_binary8;
+
+    uint32_t generations = 0;
+    uint32_t generations_decoded = 0;
+
+    // The generation that is currently being decoded
+    uint32_t generation = 0;
+    uint8_t decoding = 0;
+
+    krlnc_decoder_t decoder = NULL;
+
+    // The packet slots in the registered buffer, every slot has a receive
+    // operation in flight
+    uint32_t stride = 0;
+    uint8_t* packets = NULL;
+
+    uint32_t block_size = 0;
+    uint8_t* data_out = NULL;
+
+    uint64_t packets_received = 0;
+    double start = 0;
+    double end = 0;
+
+    if (argc != 4)
+    {
+        printf("usage : %s <port> <symbols> <generations>\n", argv[0]);
+        exit(1);
+    }
+
+    symbols = atoi(argv[2]);
+    generations = atoi(argv[3]);
+
+    // Socket creation
+    socket_descriptor = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_descriptor < 0)
+    {
+        printf("%s: cannot open socket \n", argv[0]);
+        exit(1);
+    }
+
+    setsockopt(socket_descriptor, SOL_SOCKET, SO_RCVBUF,
+               &buffer_size, sizeof(buffer_size));
+
+    // Bind local server port
+    memset(&local_address, 0, sizeof(local_address));
+    local_address.sin_family = AF_INET;
+    local_address.sin_addr.s_addr = htonl(INADDR_ANY);
+    local_address.sin_port = htons(atoi(argv[1]));
+    return_code = bind(socket_descriptor, (struct sockaddr*) &local_address,
+                       sizeof(local_address));
+
+    if (return_code < 0)
+    {
+        printf("%s: cannot bind port number %d \n", argv[0], atoi(argv[1]));
+        exit(1);
+    }
+
+    return_code = io_uring_queue_init(QUEUE_DEPTH, &ring, 0);
+    if (return_code < 0)
+    {
+        printf("%s: cannot create io_uring: %s\n", argv[0],
+               strerror(-return_code));
+        exit(1);
+    }
+
+    decoder = krlnc_create_decoder(finite_field, symbols, symbol_size);
+
+    // Every generation is decoded into the same buffer. In a real
+    // application the data would be copied out or handed over when a
+    // generation is complete.
+    block_size = krlnc_decoder_block_size(decoder);
+    data_out = (uint8_t*) malloc(block_size);
+    krlnc_decoder_set_symbols_storage(decoder, data_out);
+
+    // Register the packet slots with the kernel. The packets are received
+    // directly into the slots, and the decoder consumes them in place.
+    stride = HEADER_SIZE + krlnc_decoder_max_payload_size(decoder);
+    packets = (uint8_t*) malloc(stride * QUEUE_DEPTH);
+
+    buffer.iov_base = packets;
+    buffer.iov_len = stride * QUEUE_DEPTH;
+
+    return_code = io_uring_register_buffers(&ring, &buffer, 1);
+    if (return_code < 0)
+    {
+        printf("%s: cannot register buffers: %s\n", argv[0],
+               strerror(-return_code));
+        exit(1);
+    }
+
+    for (i = 0; i < QUEUE_DEPTH; ++i)
+        receive_into_slot(&ring, socket_descriptor, packets, stride, i);
+
+    io_uring_submit(&ring);
+
+    printf("%s: waiting for data on UDP port %u\n", argv[0], atoi(argv[1]));
+
+    // Stop waiting if the sender has been silent for a second
+    timeout.tv_sec = 1;
+    timeout.tv_nsec = 0;
+
+    // Receiver loop
+    while (generations_decoded < generations)
+    {
+        // Submit the receive operations that were queued in the previous
+        // iteration and wait for the next packet with a single system call.
+        // io_uring_wait_cqe_timeout() cannot be used for this, since it
+        // does not submit anything on kernels with IORING_FEAT_EXT_ARG.
+        return_code = io_uring_submit_and_wait_timeout(
+            &ring, &cqe, 1, &timeout, NULL);
+
+        if (return_code == -ETIME)
+        {
+            // The sender is done, or the remaining packets were lost
+            if (packets_received > 0)
+                break;
+
+            continue;
+        }
+
+        if (return_code < 0)
+        {
+            printf("%s: io_uring_submit_and_wait_timeout error: %s\n",
+                   argv[0], strerror(-return_code));
+            break;
+        }
+
+        if (packets_received == 0)
+            start = now_seconds();
+
+        // Handle all the packets that have arrived
+        do
+        {
+            uint32_t slot = (uint32_t) (uintptr_t) io_uring_cqe_get_data(cqe);
+            uint8_t* packet = packets + slot * stride;
+
+            if (cqe->res > HEADER_SIZE)
+            {
+                uint32_t header = 0;
+                uint32_t packet_generation = 0;
+
+                ++packets_received;
+
+                memcpy(&header, packet, HEADER_SIZE);
+                packet_generation = ntohl(header);
+
+                // Start decoding a new generation. Packets from older
+                // generations arrive too late and are dropped.
+                if (!decoding || packet_generation > generation)
+                {
+                    krlnc_reset_decoder(decoder);
+                    krlnc_decoder_set_symbols_storage(decoder, data_out);
+                    generation = packet_generation;
+                    decoding = 1;
+                }
+
+                if (packet_generation == generation &&
+                    !krlnc_decoder_is_complete(decoder))
+                {
+                    // The payload is consumed directly from the buffer that
+                    // the kernel received it into
+                    krlnc_decoder_consume_payload(
+                        decoder, packet + HEADER_SIZE);
+
+                    if (krlnc_decoder_is_complete(decoder))
+                    {
+                        ++generations_decoded;
+                        end = now_seconds();
+                    }
+                }
+            }
+
+            io_uring_cqe_seen(&ring, cqe);
+
+            // Reuse the slot for a new packet
+            receive_into_slot(&ring, socket_descriptor, packets, stride,
+                              slot);
+        }
+        while (io_uring_peek_cqe(&ring, &cqe) == 0);
+    }
+
+    printf("Received %llu packets, decoded %u of %u generations\n",
+           (unsigned long long) packets_received, generations_decoded,
+           generations);
+
+    if (generations_decoded > 0 && end > start)
+    {
+        double elapsed = end - start;
+        double goodput = (double) generations_decoded * block_size * 8;
+
+        printf("Packet rate: %.0f packets/s\n", packets_received / elapsed);
+        printf("Goodput: %.3f Gbit/s\n", goodput / elapsed / 1e9);
+    }
+
+    // Cleanup, closing the ring cancels the pending receive operations
+    io_uring_queue_exit(&ring);
+    close(socket_descriptor);
+
+    free(data_out);
+    free(packets);
+
+    krlnc_delete_decoder(decoder);
+
+    return 0;
+}
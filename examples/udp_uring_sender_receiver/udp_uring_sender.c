@@ -0,0 +1,305 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF EVALUATION LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <kodo_rlnc_c/encoder.h>
+
+#include <liburing.h>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <assert.h>
+
+// The number of packets that can be in flight at the same time
+#define QUEUE_DEPTH 256
+
+// Every packet starts with the generation number in network byte order,
+// so the receiver knows when to start decoding a new generation
+#define HEADER_SIZE 4
+
+// Give up when this many sends fail in a row, as the errors will not go
+// away by themselves
+#define MAX_CONSECUTIVE_ERRORS (4 * QUEUE_DEPTH)
+
+// A full socket buffer or an ICMP error from the receiver only fails the
+// current send. Any other error, e.g. a bad descriptor or buffer, is fatal.
+static int is_transient_error(int error)
+{
+    return error == ENOBUFS || error == EAGAIN || error == ECONNREFUSED;
+}
+
+static double now_seconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+int main(int argc, char* argv[])
+{
+    // Variables needed for the network / socket usage
+    int32_t socket_descriptor;
+    int32_t return_code;
+    uint32_t i;
+    int buffer_size = 8 * 1024 * 1024;
+
+    struct sockaddr_in remote_address;
+    struct hostent* host;
+
+    struct io_uring ring;
+    struct io_uring_cqe* cqe = NULL;
+    struct iovec buffer;
+
+    // Variables needed for the coding
+    uint32_t symbols = 32;
+    uint32_t symbol_size = 1024;
+    int32_t finite_field = krlnc_binary8;
+
+    uint32_t generations = 0;
+    uint32_t extra_payloads = 0;
+    uint32_t generation = 0;
+    uint32_t remaining = 0;
+
+    krlnc_encoder_t encoder = NULL;
+
+    // The packet slots. A slot is free when it is not used by a send
+    // operation, and the free slots are kept in a stack.
+    uint32_t stride = 0;
+    uint8_t* packets = NULL;
+    uint32_t free_slots[QUEUE_DEPTH];
+    uint32_t free_count = 0;
+
+    // The data to be encoded
+    uint32_t block_size = 0;
+    uint8_t* data_in = NULL;
+
+    uint64_t packets_sent = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t send_errors = 0;
+    uint32_t consecutive_errors = 0;
+    int fatal_error = 0;
+    double start = 0;
+    double elapsed = 0;
+
+    // Check command line args
+    if (argc != 6)
+    {
+        printf("usage : %s <server> <port> <symbols> <generations> "
+               "<extra_payloads>\n", argv[0]);
+
+        exit(1);
+    }
+
+    // Get server IP address (no check if input is IP address or DNS name)
+    host = gethostbyname(argv[1]);
+    if (host == NULL)
+    {
+        printf("%s: unknown host '%s' \n", argv[0], argv[1]);
+        exit(1);
+    }
+
+    printf("Sending data to '%s:%d' (IP: %s) \n", host->h_name,
+           atoi(argv[2]), inet_ntoa(*(struct in_addr*)host->h_addr_list[0]));
+
+    memset(&remote_address, 0, sizeof(remote_address));
+    remote_address.sin_family = host->h_addrtype;
+    memcpy((char*) &remote_address.sin_addr.s_addr,
+           host->h_addr_list[0], host->h_length);
+    remote_address.sin_port = htons(atoi(argv[2]));
+
+    symbols = atoi(argv[3]);
+    generations = atoi(argv[4]);
+    extra_payloads = atoi(argv[5]);
+
+    // Socket creation
+    socket_descriptor = socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_descriptor < 0)
+    {
+        printf("%s: cannot open socket \n", argv[0]);
+        exit(1);
+    }
+
+    setsockopt(socket_descriptor, SOL_SOCKET, SO_SNDBUF,
+               &buffer_size, sizeof(buffer_size));
+
+    // Connect the socket, so every packet can be sent with a plain write
+    return_code = connect(socket_descriptor,
+                          (struct sockaddr*) &remote_address,
+                          sizeof(remote_address));
+
+    if (return_code < 0)
+    {
+        printf("%s: cannot connect socket\n", argv[0]);
+        exit(1);
+    }
+
+    return_code = io_uring_queue_init(QUEUE_DEPTH, &ring, 0);
+    if (return_code < 0)
+    {
+        printf("%s: cannot create io_uring: %s\n", argv[0],
+               strerror(-return_code));
+        exit(1);
+    }
+
+    // Create the encoder
+    encoder = krlnc_create_encoder(finite_field, symbols, symbol_size);
+
+    // Create some data to encode, the same data is sent in every generation
+    block_size = krlnc_encoder_block_size(encoder);
+    data_in = (uint8_t*) malloc(block_size);
+
+    for (i = 0; i < block_size; ++i)
+        data_in[i] = rand() % 256;
+
+    // Each packet slot has room for the header and the largest payload
+    stride = HEADER_SIZE + krlnc_encoder_max_payload_size(encoder);
+    packets = (uint8_t*) malloc(stride * QUEUE_DEPTH);
+
+    for (i = 0; i < QUEUE_DEPTH; ++i)
+        free_slots[free_count++] = i;
+
+    // Register the packet slots with the kernel. The encoder produces the
+    // payloads directly into the slots, and the pages are pinned once
+    // instead of being mapped for every send. The data to be encoded is
+    // not registered, because it is only read by the encoder and never
+    // by the kernel.
+    buffer.iov_base = packets;
+    buffer.iov_len = stride * QUEUE_DEPTH;
+
+    return_code = io_uring_register_buffers(&ring, &buffer, 1);
+    if (return_code < 0)
+    {
+        printf("%s: cannot register buffers: %s\n", argv[0],
+               strerror(-return_code));
+        exit(1);
+    }
+
+    start = now_seconds();
+
+    remaining = symbols + extra_payloads;
+    krlnc_encoder_set_symbols_storage(encoder, data_in);
+
+    // After a fatal error no new packets are queued, but the packets in
+    // flight are still completed before the slots are freed
+    while ((generation < generations && fatal_error == 0) ||
+           free_count < QUEUE_DEPTH)
+    {
+        uint32_t header = htonl(generation);
+
+        // Fill all free slots with new packets
+        while (generation < generations && fatal_error == 0 &&
+               free_count > 0)
+        {
+            uint32_t slot = 0;
+            uint8_t* packet = NULL;
+            uint32_t bytes_used = 0;
+            struct io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+
+            // The submission queue is full, so hand the queued packets to
+            // the kernel to make room
+            if (sqe == NULL)
+            {
+                io_uring_submit(&ring);
+                sqe = io_uring_get_sqe(&ring);
+            }
+
+            if (sqe == NULL)
+                break;
+
+            slot = free_slots[--free_count];
+            packet = packets + slot * stride;
+
+            memcpy(packet, &header, HEADER_SIZE);
+            bytes_used = krlnc_encoder_produce_payload(
+                encoder, packet + HEADER_SIZE);
+
+            io_uring_prep_write_fixed(sqe, socket_descriptor, packet,
+                                      HEADER_SIZE + bytes_used, 0, 0);
+            io_uring_sqe_set_data(sqe, (void*) (uintptr_t) slot);
+
+            bytes_sent += HEADER_SIZE + bytes_used;
+
+            if (--remaining == 0)
+            {
+                // Move on to the next generation
+                ++generation;
+                header = htonl(generation);
+                remaining = symbols + extra_payloads;
+
+                krlnc_reset_encoder(encoder);
+                krlnc_encoder_set_symbols_storage(encoder, data_in);
+            }
+        }
+
+        // Submit all the new packets and wait for at least one to be sent
+        // with a single system call
+        return_code = io_uring_submit_and_wait(&ring, 1);
+        if (return_code < 0)
+        {
+            printf("%s: io_uring_submit_and_wait error: %s\n", argv[0],
+                   strerror(-return_code));
+            exit(1);
+        }
+
+        // Return the slots of all completed packets to the free list
+        while (io_uring_peek_cqe(&ring, &cqe) == 0)
+        {
+            if (cqe->res < 0)
+            {
+                ++send_errors;
+                ++consecutive_errors;
+
+                if (fatal_error == 0 &&
+                    (!is_transient_error(-cqe->res) ||
+                     consecutive_errors >= MAX_CONSECUTIVE_ERRORS))
+                {
+                    printf("%s: send error: %s\n", argv[0],
+                           strerror(-cqe->res));
+                    fatal_error = 1;
+                }
+            }
+            else
+            {
+                ++packets_sent;
+                consecutive_errors = 0;
+            }
+
+            free_slots[free_count++] = (uint32_t) (uintptr_t)
+                io_uring_cqe_get_data(cqe);
+
+            io_uring_cqe_seen(&ring, cqe);
+        }
+    }
+
+    elapsed = now_seconds() - start;
+
+    printf("Sent %llu packets (%u generations) in %.3f seconds\n",
+           (unsigned long long) packets_sent, generations, elapsed);
+    printf("Send errors: %llu\n", (unsigned long long) send_errors);
+    printf("Packet rate: %.0f packets/s\n", packets_sent / elapsed);
+    printf("Throughput: %.3f Gbit/s\n", bytes_sent * 8 / elapsed / 1e9);
+
+    // Clean up
+    io_uring_queue_exit(&ring);
+    close(socket_descriptor);
+
+    free(data_in);
+    free(packets);
+
+    krlnc_delete_encoder(encoder);
+
+    return fatal_error;
+}
@@ -0,0 +1,337 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include "block_decoder.h"
+
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include <kodo_rlnc/coders.hpp>
+
+#include "convert_enums.hpp"
+#include "detail/file_mapping.hpp"
+#include "detail/generation_id.hpp"
+
+struct krlnc_block_decoder
+{
+    krlnc_block_decoder(fifi::finite_field field, uint32_t symbols,
+                        uint32_t symbol_size) :
+        m_field(field),
+        m_symbols(symbols),
+        m_symbol_size(symbol_size)
+    {
+        // Create the first decoder up front, it is also used to look up
+        // the payload size
+        m_free.emplace_back(
+            new kodo_rlnc::decoder(field, symbols, symbol_size));
+        m_max_payload_size = m_free.back()->max_payload_size();
+    }
+
+    fifi::finite_field m_field;
+    uint32_t m_symbols;
+    uint32_t m_symbol_size;
+    uint32_t m_max_payload_size;
+
+    uint8_t* m_data = nullptr;
+    uint64_t m_size = 0;
+    uint32_t m_generations = 0;
+    uint32_t m_generations_complete = 0;
+
+    // The decoders of the generations that are currently being decoded,
+    // and how many of them there may be
+    std::vector<std::unique_ptr<kodo_rlnc::decoder>> m_active;
+    uint32_t m_active_count = 0;
+    uint32_t m_max_active = 16;
+
+    // The number of payloads that were ignored because they would have
+    // started a new generation while the maximum number was active
+    uint64_t m_dropped_payloads = 0;
+
+    // Decoders that are reset and ready to be used for a new generation
+    std::vector<std::unique_ptr<kodo_rlnc::decoder>> m_free;
+
+    // Non-zero for each generation that is completely decoded
+    std::vector<uint8_t> m_complete;
+
+    // Storage for the symbols of the last generation that extend beyond
+    // the end of the data
+    std::vector<uint8_t> m_padding;
+
+    // The file that is decoded into, if any
+    file_mapping m_file;
+};
+
+static uint64_t block_size(krlnc_block_decoder_t decoder)
+{
+    return static_cast<uint64_t>(decoder->m_symbols) * decoder->m_symbol_size;
+}
+
+// Return the number of generations that data of the given size is split
+// into. The generations are counted and identified with 32-bit integers,
+// so the data is rejected if the count does not fit.
+static uint64_t generation_count(krlnc_block_decoder_t decoder, uint64_t size)
+{
+    uint64_t generations = size / block_size(decoder);
+    if (size % block_size(decoder) != 0)
+        ++generations;
+
+    return generations;
+}
+
+static std::unique_ptr<kodo_rlnc::decoder> take_decoder(
+    krlnc_block_decoder_t decoder, uint32_t generation)
+{
+    std::unique_ptr<kodo_rlnc::decoder> impl;
+
+    if (decoder->m_free.empty())
+    {
+        impl.reset(new kodo_rlnc::decoder(
+            decoder->m_field, decoder->m_symbols, decoder->m_symbol_size));
+    }
+    else
+    {
+        impl = std::move(decoder->m_free.back());
+        decoder->m_free.pop_back();
+    }
+
+    uint32_t symbol_size = decoder->m_symbol_size;
+    uint64_t offset = generation * block_size(decoder);
+
+    if (offset + block_size(decoder) <= decoder->m_size)
+    {
+        impl->set_symbols_storage(decoder->m_data + offset);
+        return impl;
+    }
+
+    // The symbols of the last generation that extend beyond the end of the
+    // data are decoded into the padding, and the part that belongs to the
+    // data is copied out when the generation is complete
+    uint32_t full_symbols =
+        static_cast<uint32_t>((decoder->m_size - offset) / symbol_size);
+
+    decoder->m_padding.resize(
+        (decoder->m_symbols - full_symbols) * symbol_size);
+
+    for (uint32_t i = 0; i < decoder->m_symbols; ++i)
+    {
+        if (i < full_symbols)
+        {
+            impl->set_symbol_storage(
+                decoder->m_data + offset + i * symbol_size, i);
+        }
+        else
+        {
+            impl->set_symbol_storage(
+                decoder->m_padding.data() + (i - full_symbols) * symbol_size,
+                i);
+        }
+    }
+
+    return impl;
+}
+
+static void complete_generation(
+    krlnc_block_decoder_t decoder, uint32_t generation)
+{
+    uint64_t offset = generation * block_size(decoder);
+
+    if (offset + block_size(decoder) > decoder->m_size)
+    {
+        uint32_t symbol_size = decoder->m_symbol_size;
+        uint64_t full_bytes =
+            (decoder->m_size - offset) / symbol_size * symbol_size;
+        uint32_t remaining =
+            static_cast<uint32_t>(decoder->m_size - offset - full_bytes);
+
+        std::memcpy(decoder->m_data + offset + full_bytes,
+                    decoder->m_padding.data(), remaining);
+    }
+
+    std::unique_ptr<kodo_rlnc::decoder> impl =
+        std::move(decoder->m_active[generation]);
+    impl->reset();
+    decoder->m_free.push_back(std::move(impl));
+    --decoder->m_active_count;
+
+    decoder->m_complete[generation] = 1;
+    ++decoder->m_generations_complete;
+}
+
+//------------------------------------------------------------------
+// BLOCK DECODER BASIC API
+//------------------------------------------------------------------
+
+krlnc_block_decoder_t krlnc_create_block_decoder(
+    int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size)
+{
+    auto finite_field = c_field_to_krlnc_field(finite_field_id);
+    return new krlnc_block_decoder(finite_field, symbols, symbol_size);
+}
+
+void krlnc_delete_block_decoder(krlnc_block_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    delete decoder;
+}
+
+//------------------------------------------------------------------
+// DATA API
+//------------------------------------------------------------------
+
+uint8_t krlnc_block_decoder_set_data(
+    krlnc_block_decoder_t decoder, uint8_t* data, uint64_t size)
+{
+    assert(decoder != nullptr);
+    assert(data != nullptr || size == 0);
+
+    uint64_t generations = generation_count(decoder, size);
+    if (generations > UINT32_MAX)
+        return 0;
+
+    // Keep the decoders of unfinished generations for later use
+    for (auto& impl : decoder->m_active)
+    {
+        if (!impl)
+            continue;
+
+        impl->reset();
+        decoder->m_free.push_back(std::move(impl));
+    }
+
+    decoder->m_data = data;
+    decoder->m_size = size;
+    decoder->m_generations = static_cast<uint32_t>(generations);
+    decoder->m_generations_complete = 0;
+
+    decoder->m_active.clear();
+    decoder->m_active_count = 0;
+    decoder->m_active.resize(decoder->m_generations);
+    decoder->m_complete.assign(decoder->m_generations, 0);
+    decoder->m_dropped_payloads = 0;
+    return 1;
+}
+
+uint8_t krlnc_block_decoder_set_file(
+    krlnc_block_decoder_t decoder, const char* path, uint64_t size)
+{
+    assert(decoder != nullptr);
+    assert(path != nullptr);
+
+    // The file is only created if the size is accepted
+    if (generation_count(decoder, size) > UINT32_MAX)
+        return 0;
+
+    if (!decoder->m_file.open_write(path, 0, size, true))
+        return 0;
+
+    return krlnc_block_decoder_set_data(decoder, decoder->m_file.data(), size);
+}
+
+uint32_t krlnc_block_decoder_generations(krlnc_block_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_generations;
+}
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+uint32_t krlnc_block_decoder_max_payload_size(krlnc_block_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return max_generation_id_size + decoder->m_max_payload_size;
+}
+
+void krlnc_block_decoder_consume_payload(
+    krlnc_block_decoder_t decoder, uint8_t* payload, uint32_t payload_size)
+{
+    assert(decoder != nullptr);
+    assert(payload != nullptr);
+
+    uint32_t generation = 0;
+    uint32_t header = read_generation_id(payload, payload_size, &generation);
+
+    if (header == 0 || header == payload_size ||
+        generation >= decoder->m_generations ||
+        decoder->m_complete[generation])
+    {
+        return;
+    }
+
+    auto& impl = decoder->m_active[generation];
+    if (!impl)
+    {
+        if (decoder->m_active_count == decoder->m_max_active)
+        {
+            ++decoder->m_dropped_payloads;
+            return;
+        }
+
+        impl = take_decoder(decoder, generation);
+        ++decoder->m_active_count;
+    }
+
+    impl->consume_payload(payload + header);
+
+    if (impl->is_complete())
+        complete_generation(decoder, generation);
+}
+
+void krlnc_block_decoder_set_max_active_generations(
+    krlnc_block_decoder_t decoder, uint32_t generations)
+{
+    assert(decoder != nullptr);
+    assert(generations > 0);
+    decoder->m_max_active = generations;
+}
+
+uint32_t krlnc_block_decoder_max_active_generations(
+    krlnc_block_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_max_active;
+}
+
+uint32_t krlnc_block_decoder_active_generations(
+    krlnc_block_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_active_count;
+}
+
+uint64_t krlnc_block_decoder_dropped_payloads(krlnc_block_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_dropped_payloads;
+}
+
+//------------------------------------------------------------------
+// DECODER API
+//------------------------------------------------------------------
+
+uint8_t krlnc_block_decoder_is_complete(krlnc_block_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_generations_complete == decoder->m_generations;
+}
+
+uint32_t krlnc_block_decoder_generations_complete(
+    krlnc_block_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_generations_complete;
+}
+
+uint8_t krlnc_block_decoder_is_generation_complete(
+    krlnc_block_decoder_t decoder, uint32_t generation)
+{
+    assert(decoder != nullptr);
+    assert(generation < decoder->m_generations);
+    return decoder->m_complete[generation];
+}
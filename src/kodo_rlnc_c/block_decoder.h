@@ -0,0 +1,181 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------
+// KODO-RLNC-C TYPES
+//------------------------------------------------------------------
+
+/// Opaque pointer used for block decoder
+typedef struct krlnc_block_decoder* krlnc_block_decoder_t;
+
+//------------------------------------------------------------------
+// BLOCK DECODER BASIC API
+//------------------------------------------------------------------
+
+/// Create a new block decoder object. A block decoder reassembles data
+/// that was split into generations by a block encoder. Payloads for
+/// different generations can be consumed in any order. A decoder is only
+/// kept for the generations that are currently being decoded, and the
+/// decoders of completed generations are reused for new generations.
+/// @param finite_field_id The finite field that should be used.
+/// @param symbols The number of symbols in a generation
+/// @param symbol_size The size of a symbol in bytes
+/// @return Pointer to a new block decoder instance.
+KODO_RLNC_API
+krlnc_block_decoder_t krlnc_create_block_decoder(
+    int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size);
+
+/// Deallocate and release the memory consumed by a block decoder
+/// @param decoder The block decoder which should be deallocated
+KODO_RLNC_API
+void krlnc_delete_block_decoder(krlnc_block_decoder_t decoder);
+
+//------------------------------------------------------------------
+// DATA API
+//------------------------------------------------------------------
+
+/// Specify the buffer where the decoded data should be stored. This resets
+/// the decoding state of all generations.
+/// The buffer is not copied, so it must stay valid while the block
+/// decoder uses it.
+/// @param decoder The block decoder which will decode the data
+/// @param data The buffer that should contain the decoded data
+/// @param size The size of the data in bytes
+/// @return Non-zero if the data was accepted, or 0 if it would be split
+///         into more than 2^32 - 1 generations, in which case the data
+///         buffer and the decoding state are unchanged
+KODO_RLNC_API
+uint8_t krlnc_block_decoder_set_data(
+    krlnc_block_decoder_t decoder, uint8_t* data, uint64_t size);
+
+/// Specify a file where the decoded data should be stored. The file is
+/// created or resized to the given size and mapped into memory, and it is
+/// used as the data buffer as if it was passed to
+/// krlnc_block_decoder_set_data(). The generations are decoded directly
+/// into the page cache, and the kernel writes them back to the file. The
+/// file stays mapped until the block decoder is deleted or another file is
+/// specified. Unlike krlnc_decoder_set_file_storage(), which only maps a
+/// block of a larger file, the block decoder owns the whole file, so a
+/// longer file is also shortened to the given size. Memory mapped files
+/// are only supported on POSIX systems.
+/// @param decoder The block decoder which will decode the data
+/// @param path The path of the file
+/// @param size The size of the data in bytes
+/// @return Non-zero if the file was mapped, otherwise 0, in which case the
+///         data buffer is unchanged. The file is not touched if
+///         krlnc_block_decoder_set_data() would not accept the size.
+KODO_RLNC_API
+uint8_t krlnc_block_decoder_set_file(
+    krlnc_block_decoder_t decoder, const char* path, uint64_t size);
+
+/// Return the number of generations that the data is split into.
+/// @param decoder The block decoder to query
+/// @return The number of generations
+KODO_RLNC_API
+uint32_t krlnc_block_decoder_generations(krlnc_block_decoder_t decoder);
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+/// Return the maximum payload size of a block decoder, which includes the
+/// generation id that prefixes every payload.
+/// @param decoder The block decoder to query.
+/// @return The payload size in bytes
+KODO_RLNC_API
+uint32_t krlnc_block_decoder_max_payload_size(krlnc_block_decoder_t decoder);
+
+/// Consume a payload produced by a block encoder. Payloads with an invalid
+/// generation id, and payloads for unknown or already completed generations
+/// are ignored. A payload that would start decoding a new generation is
+/// also ignored while the maximum number of generations is being decoded,
+/// see krlnc_block_decoder_set_max_active_generations(). Such payloads are
+/// counted, see krlnc_block_decoder_dropped_payloads().
+/// @param decoder The block decoder to use.
+/// @param payload The buffer storing the payload.
+///        The payload buffer may be changed by this operation,
+///        so it cannot be reused. If the payload is needed at several places,
+///        make sure to keep a copy of the original payload.
+/// @param payload_size The size of the payload in bytes
+KODO_RLNC_API
+void krlnc_block_decoder_consume_payload(
+    krlnc_block_decoder_t decoder, uint8_t* payload, uint32_t payload_size);
+
+/// Set the maximum number of generations that are decoded at the same
+/// time. Every generation that is being decoded holds a decoder, so this
+/// bounds the memory used when payloads of many generations are
+/// interleaved. The default is 16.
+/// @param decoder The block decoder to configure
+/// @param generations The maximum number of generations, at least 1
+KODO_RLNC_API
+void krlnc_block_decoder_set_max_active_generations(
+    krlnc_block_decoder_t decoder, uint32_t generations);
+
+/// Return the maximum number of generations that are decoded at the same
+/// time.
+/// @param decoder The block decoder to query
+/// @return The maximum number of generations
+KODO_RLNC_API
+uint32_t krlnc_block_decoder_max_active_generations(
+    krlnc_block_decoder_t decoder);
+
+/// Return the number of generations that are currently being decoded,
+/// i.e. that have received payloads but are not complete.
+/// @param decoder The block decoder to query
+/// @return The number of generations
+KODO_RLNC_API
+uint32_t krlnc_block_decoder_active_generations(
+    krlnc_block_decoder_t decoder);
+
+/// Return the number of payloads that were ignored because they would have
+/// started decoding a new generation while the maximum number of
+/// generations was being decoded. A steadily growing count means that the
+/// sender interleaves more generations than the decoder accepts, and that
+/// the maximum should be raised. The count is cleared when the data is
+/// specified.
+/// @param decoder The block decoder to query
+/// @return The number of dropped payloads
+KODO_RLNC_API
+uint64_t krlnc_block_decoder_dropped_payloads(krlnc_block_decoder_t decoder);
+
+//------------------------------------------------------------------
+// DECODER API
+//------------------------------------------------------------------
+
+/// Check whether all generations are decoded.
+/// @param decoder The block decoder to query
+/// @return Non-zero value if the decoding is complete, otherwise 0
+KODO_RLNC_API
+uint8_t krlnc_block_decoder_is_complete(krlnc_block_decoder_t decoder);
+
+/// Return the number of generations that are completely decoded.
+/// @param decoder The block decoder to query
+/// @return The number of decoded generations
+KODO_RLNC_API
+uint32_t krlnc_block_decoder_generations_complete(
+    krlnc_block_decoder_t decoder);
+
+/// Check whether a generation is decoded. The data of a decoded generation
+/// is available in the data buffer.
+/// @param decoder The block decoder to query
+/// @param generation The index of the generation to check
+/// @return Non-zero value if the generation is decoded, otherwise 0
+KODO_RLNC_API
+uint8_t krlnc_block_decoder_is_generation_complete(
+    krlnc_block_decoder_t decoder, uint32_t generation);
+
+#ifdef __cplusplus
+}
+#endif
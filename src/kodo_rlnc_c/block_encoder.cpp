@@ -0,0 +1,221 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include "block_encoder.h"
+
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include <vector>
+
+#include <kodo_rlnc/coders.hpp>
+
+#include "convert_enums.hpp"
+#include "detail/file_mapping.hpp"
+#include "detail/generation_id.hpp"
+
+struct krlnc_block_encoder
+{
+    krlnc_block_encoder(fifi::finite_field field, uint32_t symbols,
+                        uint32_t symbol_size) :
+        m_impl(field, symbols, symbol_size),
+        m_padding(2 * symbol_size)
+    { }
+
+    kodo_rlnc::encoder m_impl;
+
+    uint8_t* m_data = nullptr;
+    uint64_t m_size = 0;
+    uint32_t m_generations = 0;
+    uint32_t m_generation = 0;
+
+    // Configuration that is re-applied every time the encoder is reset
+    kodo_rlnc::coding_vector_format m_format =
+        kodo_rlnc::coding_vector_format::full_vector;
+    bool m_systematic = true;
+
+    // Storage for the last, partially filled symbol followed by a zero
+    // symbol that is used for all symbols after the end of the data
+    std::vector<uint8_t> m_padding;
+
+    // The file that is encoded, if any
+    file_mapping m_file;
+};
+
+static void configure_generation(krlnc_block_encoder_t encoder)
+{
+    kodo_rlnc::encoder& impl = encoder->m_impl;
+
+    impl.reset();
+    impl.set_coding_vector_format(encoder->m_format);
+    if (encoder->m_systematic)
+        impl.set_systematic_on();
+    else
+        impl.set_systematic_off();
+
+    uint32_t symbol_size = impl.symbol_size();
+    uint64_t offset = encoder->m_generation * impl.block_size();
+
+    if (offset + impl.block_size() <= encoder->m_size)
+    {
+        impl.set_symbols_storage(encoder->m_data + offset);
+        return;
+    }
+
+    // The last generation is only partially filled, so every symbol that
+    // extends beyond the end of the data is served from the padding
+    uint8_t* partial = encoder->m_padding.data();
+    uint8_t* zero = encoder->m_padding.data() + symbol_size;
+
+    for (uint32_t i = 0; i < impl.symbols(); ++i)
+    {
+        uint64_t start = offset + i * symbol_size;
+
+        if (start + symbol_size <= encoder->m_size)
+        {
+            impl.set_symbol_storage(encoder->m_data + start, i);
+        }
+        else if (start < encoder->m_size)
+        {
+            uint32_t remaining = static_cast<uint32_t>(encoder->m_size - start);
+            std::memcpy(partial, encoder->m_data + start, remaining);
+            std::memset(partial + remaining, 0, symbol_size - remaining);
+            impl.set_symbol_storage(partial, i);
+        }
+        else
+        {
+            impl.set_symbol_storage(zero, i);
+        }
+    }
+}
+
+//------------------------------------------------------------------
+// BLOCK ENCODER BASIC API
+//------------------------------------------------------------------
+
+krlnc_block_encoder_t krlnc_create_block_encoder(
+    int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size)
+{
+    auto finite_field = c_field_to_krlnc_field(finite_field_id);
+    return new krlnc_block_encoder(finite_field, symbols, symbol_size);
+}
+
+void krlnc_delete_block_encoder(krlnc_block_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    delete encoder;
+}
+
+void krlnc_block_encoder_set_coding_vector_format(
+    krlnc_block_encoder_t encoder, int32_t format_id)
+{
+    assert(encoder != nullptr);
+    encoder->m_format = c_format_to_krlnc_format(format_id);
+    encoder->m_impl.set_coding_vector_format(encoder->m_format);
+}
+
+void krlnc_block_encoder_set_systematic_on(krlnc_block_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    encoder->m_systematic = true;
+    encoder->m_impl.set_systematic_on();
+}
+
+void krlnc_block_encoder_set_systematic_off(krlnc_block_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    encoder->m_systematic = false;
+    encoder->m_impl.set_systematic_off();
+}
+
+//------------------------------------------------------------------
+// DATA API
+//------------------------------------------------------------------
+
+uint8_t krlnc_block_encoder_set_data(
+    krlnc_block_encoder_t encoder, uint8_t* data, uint64_t size)
+{
+    assert(encoder != nullptr);
+    assert(data != nullptr || size == 0);
+
+    uint64_t block_size = encoder->m_impl.block_size();
+    uint64_t generations = size / block_size;
+    if (size % block_size != 0)
+        ++generations;
+
+    // The generations are counted and identified with 32-bit integers
+    if (generations > UINT32_MAX)
+        return 0;
+
+    encoder->m_data = data;
+    encoder->m_size = size;
+    encoder->m_generations = static_cast<uint32_t>(generations);
+    encoder->m_generation = 0;
+
+    if (encoder->m_generations > 0)
+        configure_generation(encoder);
+
+    return 1;
+}
+
+uint8_t krlnc_block_encoder_set_file(
+    krlnc_block_encoder_t encoder, const char* path)
+{
+    assert(encoder != nullptr);
+    assert(path != nullptr);
+
+    // The current file stays mapped until the new one is accepted
+    file_mapping file;
+    if (!file.open_read(path) ||
+        !krlnc_block_encoder_set_data(encoder, file.data(), file.size()))
+    {
+        return 0;
+    }
+
+    encoder->m_file.swap(file);
+    return 1;
+}
+
+uint32_t krlnc_block_encoder_generations(krlnc_block_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return encoder->m_generations;
+}
+
+void krlnc_block_encoder_set_generation(
+    krlnc_block_encoder_t encoder, uint32_t generation)
+{
+    assert(encoder != nullptr);
+    assert(generation < encoder->m_generations);
+
+    encoder->m_generation = generation;
+    configure_generation(encoder);
+}
+
+uint32_t krlnc_block_encoder_generation(krlnc_block_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return encoder->m_generation;
+}
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+uint32_t krlnc_block_encoder_max_payload_size(krlnc_block_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return max_generation_id_size + encoder->m_impl.max_payload_size();
+}
+
+uint32_t krlnc_block_encoder_produce_payload(
+    krlnc_block_encoder_t encoder, uint8_t* payload)
+{
+    assert(encoder != nullptr);
+    assert(encoder->m_generations > 0);
+
+    uint32_t header = write_generation_id(payload, encoder->m_generation);
+    return header + encoder->m_impl.produce_payload(payload + header);
+}
@@ -0,0 +1,138 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------
+// KODO-RLNC-C TYPES
+//------------------------------------------------------------------
+
+/// Opaque pointer used for block encoder
+typedef struct krlnc_block_encoder* krlnc_block_encoder_t;
+
+//------------------------------------------------------------------
+// BLOCK ENCODER BASIC API
+//------------------------------------------------------------------
+
+/// Create a new block encoder object. A block encoder splits a buffer of
+/// any length into generations of symbols * symbol_size bytes, and encodes
+/// one generation at a time. The last generation is padded with zeros if
+/// the data does not fill it completely. A single encoder is reused for
+/// all generations.
+/// @param finite_field_id The finite field that should be used.
+/// @param symbols The number of symbols in a generation
+/// @param symbol_size The size of a symbol in bytes
+/// @return Pointer to a new block encoder instance.
+KODO_RLNC_API
+krlnc_block_encoder_t krlnc_create_block_encoder(
+    int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size);
+
+/// Deallocate and release the memory consumed by a block encoder
+/// @param encoder The block encoder which should be deallocated
+KODO_RLNC_API
+void krlnc_delete_block_encoder(krlnc_block_encoder_t encoder);
+
+/// Set the coding vector format used for all generations
+/// @param encoder The block encoder which should be configured
+/// @param format_id The selected coding vector format
+KODO_RLNC_API
+void krlnc_block_encoder_set_coding_vector_format(
+    krlnc_block_encoder_t encoder, int32_t format_id);
+
+/// Switch the systematic encoding on for all generations
+/// @param encoder The block encoder
+KODO_RLNC_API
+void krlnc_block_encoder_set_systematic_on(krlnc_block_encoder_t encoder);
+
+/// Switch the systematic encoding off for all generations
+/// @param encoder The block encoder
+KODO_RLNC_API
+void krlnc_block_encoder_set_systematic_off(krlnc_block_encoder_t encoder);
+
+//------------------------------------------------------------------
+// DATA API
+//------------------------------------------------------------------
+
+/// Specify the data that should be encoded. The data is split into
+/// generations and the first generation is selected for encoding.
+/// The buffer is not copied, so it must stay valid while the block
+/// encoder uses it.
+/// @param encoder The block encoder which will encode the data
+/// @param data The buffer containing the data to be encoded
+/// @param size The size of the data in bytes
+/// @return Non-zero if the data was accepted, or 0 if it would be split
+///         into more than 2^32 - 1 generations, in which case the data is
+///         unchanged
+KODO_RLNC_API
+uint8_t krlnc_block_encoder_set_data(
+    krlnc_block_encoder_t encoder, uint8_t* data, uint64_t size);
+
+/// Specify a file that should be encoded. The whole file is mapped into
+/// memory and used as the data, as if it was passed to
+/// krlnc_block_encoder_set_data(), so the file is encoded directly from the
+/// page cache without being read into a buffer. The file stays mapped until
+/// the block encoder is deleted or another file is specified. Memory mapped
+/// files are only supported on POSIX systems.
+/// @param encoder The block encoder which will encode the file
+/// @param path The path of the file
+/// @return Non-zero if the file was mapped, otherwise 0, in which case the
+///         data is unchanged. A file that krlnc_block_encoder_set_data()
+///         would not accept is not mapped.
+KODO_RLNC_API
+uint8_t krlnc_block_encoder_set_file(
+    krlnc_block_encoder_t encoder, const char* path);
+
+/// Return the number of generations that the data is split into.
+/// @param encoder The block encoder to query
+/// @return The number of generations
+KODO_RLNC_API
+uint32_t krlnc_block_encoder_generations(krlnc_block_encoder_t encoder);
+
+/// Select the generation that should be encoded. The internal encoder is
+/// reset, so encoding of the generation starts from the beginning.
+/// @param encoder The block encoder to use
+/// @param generation The index of the generation to encode
+KODO_RLNC_API
+void krlnc_block_encoder_set_generation(
+    krlnc_block_encoder_t encoder, uint32_t generation);
+
+/// Return the generation that is currently being encoded.
+/// @param encoder The block encoder to query
+/// @return The index of the current generation
+KODO_RLNC_API
+uint32_t krlnc_block_encoder_generation(krlnc_block_encoder_t encoder);
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+/// Return the maximum possible payload size of a block encoder, which
+/// includes the generation id that prefixes every payload.
+/// @param encoder The block encoder to query.
+/// @return The payload size in bytes
+KODO_RLNC_API
+uint32_t krlnc_block_encoder_max_payload_size(krlnc_block_encoder_t encoder);
+
+/// Produce a payload for the current generation in the provided buffer.
+/// The payload is prefixed with the generation id, which takes a single
+/// byte for the first 128 generations.
+/// @param encoder The block encoder to use.
+/// @param payload The buffer which should contain the payload.
+/// @return The total bytes used from the payload buffer
+KODO_RLNC_API
+uint32_t krlnc_block_encoder_produce_payload(
+    krlnc_block_encoder_t encoder, uint8_t* payload);
+
+#ifdef __cplusplus
+}
+#endif
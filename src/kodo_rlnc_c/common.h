@@ -67,6 +67,22 @@ typedef enum
 }
 krlnc_coding_vector_format;
 
+/// Description of a payload that is split into a header and a symbol, which
+/// can be sent without copying using scatter/gather I/O (e.g. sendmsg).
+/// The receiver gets the two segments as one contiguous payload.
+typedef struct
+{
+    /// The payload header
+    const uint8_t* header;
+    /// The size of the payload header in bytes
+    uint32_t header_size;
+    /// The symbol data
+    const uint8_t* symbol;
+    /// The size of the symbol data in bytes
+    uint32_t symbol_size;
+}
+krlnc_payload_segments;
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,24 +5,373 @@
 
 #include "decoder.h"
 
+#include <algorithm>
 #include <cstring>
 #include <cstdint>
 #include <cassert>
+#include <memory>
+#include <random>
 #include <string>
+#include <vector>
 
 #include <kodo_rlnc/coders.hpp>
 
 #include "convert_enums.hpp"
+#include "detail/coder_cache.hpp"
+#include "detail/column_slices.hpp"
+#include "detail/feedback.hpp"
+#include "detail/file_mapping.hpp"
+#include "detail/segmented_payload.hpp"
+#include "detail/symbol_storage_table.hpp"
 
 struct krlnc_decoder
 {
-    template<class... Args>
-    krlnc_decoder(Args&&... args) :
-        m_impl(std::forward<Args>(args)...)
+    krlnc_decoder(fifi::finite_field field, uint32_t symbols,
+                  uint32_t symbol_size) :
+        m_impl(new kodo_rlnc::decoder(field, symbols, symbol_size)),
+        m_field(field),
+        m_default_status_updater(m_impl->is_status_updater_enabled())
     { }
-    kodo_rlnc::decoder m_impl;
+
+    std::unique_ptr<kodo_rlnc::decoder> m_impl;
+    fifi::finite_field m_field;
+
+    // The configuration of a new decoder, which is restored by
+    // krlnc_decoder_restore_defaults()
+    bool m_default_status_updater;
+
+    // The coders of recently used geometries, if they are kept, and the
+    // seed, which is applied when the decoder is reconfigured
+    coder_cache<kodo_rlnc::decoder> m_coders;
+    uint32_t m_seed = 0;
+    bool m_has_seed = false;
+
+    // Buffer used to consume read-only payloads, allocated on first use
+    std::vector<uint8_t> m_payload_copy;
+
+    // The file that is used as symbol storage, if any
+    file_mapping m_file;
+
+    // Cumulative statistics of all consumed payloads
+    krlnc_decoder_stats m_stats = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    // The callback for decoded symbols
+    krlnc_symbol_decoded_callback_t m_decoded_callback = nullptr;
+    void* m_decoded_context = nullptr;
+
+    // The symbol storage that is passed to the callback. Contiguous storage
+    // is tracked with its start, and the storage of individual symbols with
+    // a table.
+    uint8_t* m_symbols_storage = nullptr;
+    symbol_storage_table m_symbol_storage;
+
+    // The indices of the symbols that were not reported to the callback
+    // yet, in ascending order, and the number of reported symbols. Only
+    // tracked while there is a callback.
+    std::vector<uint32_t> m_unreported;
+    uint32_t m_reported_count = 0;
+
+    // The coders that split the symbols by column ranges. Only created if
+    // the column threads split the symbols into several slices, and then
+    // the slices hold the decoding state instead of m_impl. The thread pool
+    // is kept when the slices are rebuilt for a new geometry, until the
+    // number of threads changes.
+    std::unique_ptr<thread_pool> m_column_pool;
+    std::unique_ptr<column_slices<kodo_rlnc::decoder>> m_columns;
+    uint32_t m_column_threads = 0;
+
+    // Set once the kodo payload format is used, which rules out the column
+    // threads until the defaults are restored
+    bool m_uses_payload_api = false;
+
+    // A copy of the coefficients for every slice except the first
+    std::vector<uint8_t> m_column_coefficients;
+};
+
+// Return the coder that holds the decoding state. If the symbols are split
+// by column ranges, all slices have the same state as the first one.
+static kodo_rlnc::decoder& state(krlnc_decoder_t decoder)
+{
+    if (decoder->m_columns != nullptr)
+        return decoder->m_columns->coder(0);
+
+    return *decoder->m_impl;
+}
+
+static uint8_t* symbol_storage(krlnc_decoder_t decoder, uint32_t index)
+{
+    uint8_t* data = decoder->m_symbol_storage.get(index);
+    if (data != nullptr)
+        return data;
+
+    uint32_t symbol_size = decoder->m_impl->symbol_size();
+    if (decoder->m_symbols_storage != nullptr)
+        return decoder->m_symbols_storage + index * symbol_size;
+
+    return nullptr;
+}
+
+// Mark all symbols as unreported
+static void reset_reported(krlnc_decoder_t decoder)
+{
+    std::vector<uint32_t>& unreported = decoder->m_unreported;
+    unreported.resize(decoder->m_impl->symbols());
+
+    for (uint32_t i = 0; i < unreported.size(); ++i)
+        unreported[i] = i;
+
+    decoder->m_reported_count = 0;
+}
+
+// Invoke the decoded callback for every decoded symbol that has not been
+// reported yet. The number of decoded symbols tells how many there are, so
+// nothing is scanned if there are none, and the scan of the unreported
+// symbols stops after the last one.
+static void report_decoded_symbols(krlnc_decoder_t decoder)
+{
+    kodo_rlnc::decoder& impl = state(decoder);
+
+    if (decoder->m_decoded_callback == nullptr)
+        return;
+
+    uint32_t decoded = impl.symbols_decoded();
+    if (decoded <= decoder->m_reported_count)
+        return;
+
+    uint32_t pending = decoded - decoder->m_reported_count;
+    std::vector<uint32_t>& unreported = decoder->m_unreported;
+
+    auto kept = unreported.begin();
+    auto it = unreported.begin();
+    for (; it != unreported.end() && pending > 0; ++it)
+    {
+        uint32_t index = *it;
+        if (!impl.is_symbol_decoded(index))
+        {
+            *kept++ = index;
+            continue;
+        }
+
+        --pending;
+        ++decoder->m_reported_count;
+
+        decoder->m_decoded_callback(
+            index, symbol_storage(decoder, index), decoder->m_decoded_context);
+    }
+
+    unreported.erase(kept, it);
+}
+
+// Create the column slices for the current geometry, and give them the
+// symbol storage that is already set. The slices start without symbols.
+static void create_columns(krlnc_decoder_t decoder)
+{
+    kodo_rlnc::decoder& impl = *decoder->m_impl;
+    decoder->m_columns.reset();
+
+    uint32_t slices = column_slices<kodo_rlnc::decoder>::slice_count(
+        impl.symbol_size(), decoder->m_column_threads);
+
+    if (slices < 2)
+        return;
+
+    decoder->m_column_coefficients.resize(
+        (slices - 1) * impl.coefficient_vector_size());
+
+    if (decoder->m_column_pool == nullptr)
+    {
+        decoder->m_column_pool.reset(
+            new thread_pool(decoder->m_column_threads));
+    }
+
+    decoder->m_columns.reset(new column_slices<kodo_rlnc::decoder>(
+        decoder->m_field, impl.symbols(), impl.symbol_size(),
+        *decoder->m_column_pool));
+
+    column_slices<kodo_rlnc::decoder>& columns = *decoder->m_columns;
+    for (uint32_t slice = 0; slice < columns.slices(); ++slice)
+    {
+        if (impl.is_status_updater_enabled())
+            columns.coder(slice).set_status_updater_on();
+        else
+            columns.coder(slice).set_status_updater_off();
+    }
+
+    for (uint32_t i = 0; i < impl.symbols(); ++i)
+    {
+        uint8_t* data = symbol_storage(decoder, i);
+        if (data != nullptr)
+            columns.set_symbol_storage(data, i);
+    }
+}
+
+// Consume a coded symbol, which is split across the column threads if
+// there are several slices. Every slice changes the coefficients, so the
+// slices after the first one work on a copy.
+static void consume_symbol(
+    krlnc_decoder_t decoder, uint8_t* symbol, uint8_t* coefficients)
+{
+    if (decoder->m_columns == nullptr)
+    {
+        decoder->m_impl->consume_symbol(symbol, coefficients);
+        return;
+    }
+
+    column_slices<kodo_rlnc::decoder>& columns = *decoder->m_columns;
+    uint32_t size = decoder->m_impl->coefficient_vector_size();
+
+    for (uint32_t slice = 1; slice < columns.slices(); ++slice)
+    {
+        std::memcpy(decoder->m_column_coefficients.data() + (slice - 1) * size,
+                    coefficients, size);
+    }
+
+    columns.run([&](uint32_t slice)
+    {
+        uint8_t* slice_coefficients = slice == 0 ? coefficients :
+            decoder->m_column_coefficients.data() + (slice - 1) * size;
+
+        columns.coder(slice).consume_symbol(
+            symbol + columns.offset(slice), slice_coefficients);
+    });
+}
+
+// Consume a systematic symbol, which is split across the column threads if
+// there are several slices
+static void consume_systematic_symbol(
+    krlnc_decoder_t decoder, uint8_t* symbol, uint32_t index)
+{
+    if (decoder->m_columns == nullptr)
+    {
+        decoder->m_impl->consume_systematic_symbol(symbol, index);
+        return;
+    }
+
+    column_slices<kodo_rlnc::decoder>& columns = *decoder->m_columns;
+    columns.run([&](uint32_t slice)
+    {
+        columns.coder(slice).consume_systematic_symbol(
+            symbol + columns.offset(slice), index);
+    });
+}
+
+// Change the number of column threads of an empty decoder
+static void change_column_threads(krlnc_decoder_t decoder, uint32_t threads)
+{
+    if (threads == decoder->m_column_threads)
+        return;
+
+    decoder->m_column_threads = threads;
+    krlnc_reset_decoder(decoder);
+    decoder->m_columns.reset();
+    decoder->m_column_pool.reset();
+    create_columns(decoder);
+
+    // The decoder is used again if the symbols are no longer split, so it
+    // gets the storage that was set while they were
+    for (uint32_t i = 0; i < decoder->m_impl->symbols(); ++i)
+    {
+        uint8_t* data = symbol_storage(decoder, i);
+        if (data != nullptr)
+            decoder->m_impl->set_symbol_storage(data, i);
+    }
+}
+
+// Prepare the decoder for a payload in the kodo format, which cannot be
+// split by column ranges. The splitting is turned off if the slices hold
+// no symbols yet, otherwise their state cannot be moved to the decoder and
+// the payload must be dropped. Return true if the payload can be used.
+static bool use_payload_api(krlnc_decoder_t decoder)
+{
+    decoder->m_uses_payload_api = true;
+
+    if (decoder->m_columns == nullptr)
+        return true;
+
+    assert(state(decoder).rank() == 0 &&
+           "kodo payloads cannot be mixed with split symbols");
+
+    if (state(decoder).rank() != 0)
+        return false;
+
+    change_column_threads(decoder, 0);
+    return true;
+}
+
+// The type of a consumed payload, as far as the wrapper knows it
+enum class payload_type
+{
+    unknown,
+    systematic,
+    coded
 };
 
+// Consume a payload or symbol with the given function and update the
+// statistics, but leave the decoded symbols unreported. See
+// krlnc_decoder_get_stats() for how the operation counts are estimated.
+// The status is optional. Return true if symbols were decoded.
+template<class Function>
+static bool consume_unreported(
+    krlnc_decoder_t decoder, payload_type type, Function&& function,
+    krlnc_decoder_consume_status* status = nullptr)
+{
+    kodo_rlnc::decoder& impl = state(decoder);
+    krlnc_decoder_stats& stats = decoder->m_stats;
+
+    uint32_t rank = impl.rank();
+    uint32_t decoded = impl.symbols_decoded();
+
+    function();
+
+    bool innovative = impl.rank() > rank;
+    uint32_t decoded_after = impl.symbols_decoded();
+
+    ++stats.payloads_consumed;
+    if (innovative)
+        ++stats.innovative_payloads;
+    else
+        ++stats.linearly_dependent_payloads;
+
+    if (type == payload_type::systematic)
+        ++stats.systematic_payloads;
+    else if (type == payload_type::coded)
+        ++stats.coded_payloads;
+    else
+        ++stats.unclassified_payloads;
+
+    // The cost of an unclassified payload depends on its hidden type, so it
+    // is left out of the estimate rather than guessed
+    if (type != payload_type::unknown)
+    {
+        uint64_t forward = type == payload_type::systematic ? 0 : rank;
+        uint64_t backward = innovative ? rank - std::min(rank, decoded) : 0;
+
+        stats.estimated_multiply_add_operations += forward + backward;
+        stats.estimated_backward_substitution_operations += backward;
+    }
+
+    if (status != nullptr)
+    {
+        status->innovative = innovative;
+        status->complete = impl.is_complete();
+        status->rank = impl.rank();
+        status->symbols_decoded = decoded_after - decoded;
+    }
+
+    return decoded_after > decoded;
+}
+
+// Consume a payload or symbol and report the symbols it decoded, see
+// consume_unreported()
+template<class Function>
+static void consume(
+    krlnc_decoder_t decoder, payload_type type, Function&& function,
+    krlnc_decoder_consume_status* status = nullptr)
+{
+    if (consume_unreported(decoder, type, function, status))
+        report_decoded_symbols(decoder);
+}
+
 //------------------------------------------------------------------
 // DECODER BASIC API
 //------------------------------------------------------------------
@@ -43,7 +392,94 @@ void krlnc_delete_decoder(krlnc_decoder_t decoder)
 void krlnc_reset_decoder(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.reset();
+    decoder->m_impl->reset();
+    if (decoder->m_columns != nullptr)
+        decoder->m_columns->reset();
+
+    if (decoder->m_decoded_callback != nullptr)
+        reset_reported(decoder);
+}
+
+void krlnc_decoder_restore_defaults(krlnc_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+
+    krlnc_reset_decoder(decoder);
+    change_column_threads(decoder, 0);
+    decoder->m_uses_payload_api = false;
+    krlnc_decoder_set_symbol_decoded_callback(decoder, nullptr, nullptr);
+
+    kodo_rlnc::decoder& impl = *decoder->m_impl;
+    if (decoder->m_default_status_updater)
+        impl.set_status_updater_on();
+    else
+        impl.set_status_updater_off();
+
+    // The generator is reseeded, so that the coefficients do not follow a
+    // seed chosen by a previous user
+    if (decoder->m_has_seed)
+    {
+        impl.set_seed(std::random_device()());
+        decoder->m_has_seed = false;
+    }
+
+    impl.set_log_off();
+    impl.set_zone_prefix(std::string());
+
+    decoder->m_coders.set_max_coders(0);
+    decoder->m_symbols_storage = nullptr;
+    decoder->m_symbol_storage.clear();
+    decoder->m_file.close();
+
+    decoder->m_stats = krlnc_decoder_stats();
+}
+
+void krlnc_decoder_reconfigure(
+    krlnc_decoder_t decoder, uint32_t symbols, uint32_t symbol_size)
+{
+    assert(decoder != nullptr);
+    assert(symbols > 0);
+    assert(symbol_size > 0);
+
+    kodo_rlnc::decoder& current = *decoder->m_impl;
+
+    if (current.symbols() != symbols || current.symbol_size() != symbol_size)
+    {
+        bool status_updater = current.is_status_updater_enabled();
+
+        decoder->m_coders.select(
+            decoder->m_impl, decoder->m_field, symbols, symbol_size);
+
+        if (status_updater)
+            decoder->m_impl->set_status_updater_on();
+        else
+            decoder->m_impl->set_status_updater_off();
+    }
+
+    if (decoder->m_has_seed)
+        decoder->m_impl->set_seed(decoder->m_seed);
+
+    krlnc_reset_decoder(decoder);
+
+    // The storage of the previous geometry must be specified again
+    decoder->m_symbols_storage = nullptr;
+    decoder->m_symbol_storage.clear();
+
+    if (decoder->m_column_threads > 1)
+        create_columns(decoder);
+}
+
+void krlnc_decoder_set_reconfigure_cache(
+    krlnc_decoder_t decoder, uint32_t coders)
+{
+    assert(decoder != nullptr);
+    decoder->m_coders.set_max_coders(coders);
+}
+
+uint32_t krlnc_decoder_reconfigure_cache(krlnc_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_coders.max_coders();
 }
 
 //------------------------------------------------------------------
@@ -53,33 +489,63 @@ void krlnc_reset_decoder(krlnc_decoder_t decoder)
 uint64_t krlnc_decoder_block_size(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.block_size();
+    return decoder->m_impl->block_size();
 }
 
 uint32_t krlnc_decoder_symbol_size(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.symbol_size();
+    return decoder->m_impl->symbol_size();
 }
 
 uint32_t krlnc_decoder_symbols(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.symbols();
+    return decoder->m_impl->symbols();
 }
 
 void krlnc_decoder_set_symbol_storage(
     krlnc_decoder_t decoder, uint8_t* data, uint32_t index)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.set_symbol_storage(data, index);
+    decoder->m_impl->set_symbol_storage(data, index);
+    decoder->m_symbol_storage.remember(
+        decoder->m_impl->symbols(), data, index);
+
+    if (decoder->m_columns != nullptr)
+        decoder->m_columns->set_symbol_storage(data, index);
 }
 
 void krlnc_decoder_set_symbols_storage(
     krlnc_decoder_t decoder, uint8_t* data)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.set_symbols_storage(data);
+    decoder->m_impl->set_symbols_storage(data);
+    decoder->m_symbols_storage = data;
+    decoder->m_symbol_storage.clear();
+
+    if (decoder->m_columns != nullptr)
+    {
+        uint32_t symbol_size = decoder->m_impl->symbol_size();
+        for (uint32_t i = 0; i < decoder->m_impl->symbols(); ++i)
+            decoder->m_columns->set_symbol_storage(data + i * symbol_size, i);
+    }
+}
+
+uint8_t krlnc_decoder_set_file_storage(
+    krlnc_decoder_t decoder, const char* path, uint64_t offset)
+{
+    assert(decoder != nullptr);
+    assert(path != nullptr);
+
+    if (!decoder->m_file.open_write(
+            path, offset, decoder->m_impl->block_size(), false))
+    {
+        return 0;
+    }
+
+    krlnc_decoder_set_symbols_storage(decoder, decoder->m_file.data());
+    return 1;
 }
 
 //------------------------------------------------------------------
@@ -89,20 +555,160 @@ void krlnc_decoder_set_symbols_storage(
 uint32_t krlnc_decoder_max_payload_size(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.max_payload_size();
+    return decoder->m_impl->max_payload_size();
 }
 
 void krlnc_decoder_consume_payload(krlnc_decoder_t decoder, uint8_t* payload)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.consume_payload(payload);
+
+    if (!use_payload_api(decoder))
+        return;
+
+    consume(decoder, payload_type::unknown,
+            [&] { decoder->m_impl->consume_payload(payload); });
+}
+
+void krlnc_decoder_consume_payload_with_status(
+    krlnc_decoder_t decoder, uint8_t* payload,
+    krlnc_decoder_consume_status* status)
+{
+    assert(decoder != nullptr);
+    assert(status != nullptr);
+
+    if (!use_payload_api(decoder))
+    {
+        kodo_rlnc::decoder& impl = state(decoder);
+        status->innovative = 0;
+        status->complete = impl.is_complete();
+        status->rank = impl.rank();
+        status->symbols_decoded = 0;
+        return;
+    }
+
+    consume(decoder, payload_type::unknown,
+            [&] { decoder->m_impl->consume_payload(payload); }, status);
+}
+
+void krlnc_decoder_consume_payloads(
+    krlnc_decoder_t decoder, uint8_t* payloads, uint32_t count,
+    uint32_t stride)
+{
+    assert(decoder != nullptr);
+    assert(payloads != nullptr);
+
+    if (!use_payload_api(decoder))
+        return;
+
+    kodo_rlnc::decoder& impl = *decoder->m_impl;
+
+    // The status of the symbols is updated and reported once for the batch
+    // instead of after every payload
+    bool status_updater = impl.is_status_updater_enabled();
+    if (status_updater)
+        impl.set_status_updater_off();
+
+    bool decoded = false;
+    for (uint32_t i = 0; i < count && !impl.is_complete(); ++i)
+    {
+        decoded |= consume_unreported(decoder, payload_type::unknown,
+                                      [&] { impl.consume_payload(payloads); });
+        payloads += stride;
+    }
+
+    if (status_updater)
+    {
+        impl.set_status_updater_on();
+        impl.update_symbol_status();
+        decoded = true;
+    }
+
+    if (decoded)
+        report_decoded_symbols(decoder);
+}
+
+uint8_t krlnc_decoder_consume_payload_const(
+    krlnc_decoder_t decoder, const uint8_t* payload, uint32_t payload_size)
+{
+    assert(decoder != nullptr);
+    assert(payload != nullptr);
+    assert(payload_size <= decoder->m_impl->max_payload_size());
+
+    if (!use_payload_api(decoder))
+        return 0;
+
+    decoder->m_payload_copy.resize(decoder->m_impl->max_payload_size());
+    uint8_t* copy = decoder->m_payload_copy.data();
+
+    std::memcpy(copy, payload, payload_size);
+    consume(decoder, payload_type::unknown,
+            [&] { decoder->m_impl->consume_payload(copy); });
+    return 1;
+}
+
+uint32_t krlnc_decoder_max_segmented_payload_size(krlnc_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return max_segmented_header_size(
+        decoder->m_impl->coefficient_vector_size()) +
+        decoder->m_impl->symbol_size();
+}
+
+void krlnc_decoder_consume_segmented_payload(
+    krlnc_decoder_t decoder, uint8_t* payload, uint32_t payload_size)
+{
+    assert(decoder != nullptr);
+    assert(payload != nullptr);
+
+    kodo_rlnc::decoder& impl = state(decoder);
+    uint32_t symbol_size = decoder->m_impl->symbol_size();
+
+    if (payload_size == 0)
+        return;
+
+    if (payload[0] == segmented_systematic)
+    {
+        uint32_t header_size = 1 + sizeof(uint32_t);
+        if (payload_size < header_size + symbol_size)
+            return;
+
+        uint32_t index = read_uint32(payload + 1);
+        if (index >= impl.symbols())
+            return;
+
+        // A duplicate of a decoded symbol is not passed on, but it is
+        // still counted as a linearly dependent payload
+        consume(decoder, payload_type::systematic, [&]
+        {
+            if (!impl.is_symbol_decoded(index))
+            {
+                consume_systematic_symbol(
+                    decoder, payload + header_size, index);
+            }
+        });
+    }
+    else if (payload[0] == segmented_coded)
+    {
+        uint32_t header_size = 1 + impl.coefficient_vector_size();
+        if (payload_size < header_size + symbol_size)
+            return;
+
+        consume(decoder, payload_type::coded, [&]
+        {
+            consume_symbol(decoder, payload + header_size, payload + 1);
+        });
+    }
 }
 
 uint32_t krlnc_decoder_produce_payload(
     krlnc_decoder_t decoder, uint8_t* payload)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.produce_payload(payload);
+
+    if (!use_payload_api(decoder))
+        return 0;
+
+    return decoder->m_impl->produce_payload(payload);
 }
 
 //------------------------------------------------------------------
@@ -112,86 +718,179 @@ uint32_t krlnc_decoder_produce_payload(
 uint8_t krlnc_decoder_is_complete(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.is_complete();
+    return state(decoder).is_complete();
 }
 
 uint8_t krlnc_decoder_is_partially_complete(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.is_partially_complete();
+    return state(decoder).is_partially_complete();
 }
 
 uint32_t krlnc_decoder_rank(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.rank();
+    return state(decoder).rank();
 }
 
 uint32_t krlnc_decoder_symbols_missing(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.symbols_missing();
+    return state(decoder).symbols_missing();
 }
 
 uint32_t krlnc_decoder_symbols_partially_decoded(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.symbols_partially_decoded();
+    return state(decoder).symbols_partially_decoded();
 }
 
 uint32_t krlnc_decoder_symbols_decoded(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.symbols_decoded();
+    return state(decoder).symbols_decoded();
 }
 
 uint8_t krlnc_decoder_is_symbol_missing(krlnc_decoder_t decoder, uint32_t index)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.is_symbol_missing(index);
+    return state(decoder).is_symbol_missing(index);
 }
 
 uint8_t krlnc_decoder_is_symbol_partially_decoded(
     krlnc_decoder_t decoder, uint32_t index)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.is_symbol_partially_decoded(index);
+    return state(decoder).is_symbol_partially_decoded(index);
 }
 
 uint8_t krlnc_decoder_is_symbol_decoded(krlnc_decoder_t decoder, uint32_t index)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.is_symbol_decoded(index);
+    return state(decoder).is_symbol_decoded(index);
 }
 
 uint8_t krlnc_decoder_is_symbol_pivot(krlnc_decoder_t decoder, uint32_t index)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.is_symbol_pivot(index);
+    return state(decoder).is_symbol_pivot(index);
+}
+
+uint32_t krlnc_decoder_symbol_status_bitmap_words(krlnc_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return (decoder->m_impl->symbols() + 63) / 64;
+}
+
+void krlnc_decoder_symbol_status_bitmaps(
+    krlnc_decoder_t decoder, uint64_t* missing, uint64_t* partially_decoded,
+    uint64_t* decoded, uint64_t* pivot)
+{
+    assert(decoder != nullptr);
+
+    kodo_rlnc::decoder& impl = state(decoder);
+    uint32_t symbols = impl.symbols();
+
+    // The words are assembled in registers and written once
+    for (uint32_t word = 0; word * 64 < symbols; ++word)
+    {
+        uint64_t missing_bits = 0;
+        uint64_t partially_decoded_bits = 0;
+        uint64_t decoded_bits = 0;
+        uint64_t pivot_bits = 0;
+
+        uint32_t end = std::min(symbols, (word + 1) * 64);
+        for (uint32_t index = word * 64; index < end; ++index)
+        {
+            uint64_t bit = uint64_t(1) << (index % 64);
+
+            if (missing != nullptr && impl.is_symbol_missing(index))
+                missing_bits |= bit;
+            if (partially_decoded != nullptr &&
+                impl.is_symbol_partially_decoded(index))
+            {
+                partially_decoded_bits |= bit;
+            }
+            if (decoded != nullptr && impl.is_symbol_decoded(index))
+                decoded_bits |= bit;
+            if (pivot != nullptr && impl.is_symbol_pivot(index))
+                pivot_bits |= bit;
+        }
+
+        if (missing != nullptr)
+            missing[word] = missing_bits;
+        if (partially_decoded != nullptr)
+            partially_decoded[word] = partially_decoded_bits;
+        if (decoded != nullptr)
+            decoded[word] = decoded_bits;
+        if (pivot != nullptr)
+            pivot[word] = pivot_bits;
+    }
 }
 
 void krlnc_decoder_update_symbol_status(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.update_symbol_status();
+    if (decoder->m_columns != nullptr)
+    {
+        // The status update may substitute symbols, so every slice does it
+        column_slices<kodo_rlnc::decoder>& columns = *decoder->m_columns;
+        columns.run([&](uint32_t slice)
+        {
+            columns.coder(slice).update_symbol_status();
+        });
+    }
+    else
+    {
+        decoder->m_impl->update_symbol_status();
+    }
+
+    report_decoded_symbols(decoder);
 }
 
 void krlnc_decoder_set_status_updater_on(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.set_status_updater_on();
+    decoder->m_impl->set_status_updater_on();
+
+    if (decoder->m_columns != nullptr)
+    {
+        for (uint32_t i = 0; i < decoder->m_columns->slices(); ++i)
+            decoder->m_columns->coder(i).set_status_updater_on();
+    }
 }
 
 void krlnc_decoder_set_status_updater_off(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.set_status_updater_off();
+    decoder->m_impl->set_status_updater_off();
+
+    if (decoder->m_columns != nullptr)
+    {
+        for (uint32_t i = 0; i < decoder->m_columns->slices(); ++i)
+            decoder->m_columns->coder(i).set_status_updater_off();
+    }
+}
+
+void krlnc_decoder_set_symbol_decoded_callback(
+    krlnc_decoder_t decoder, krlnc_symbol_decoded_callback_t callback,
+    void* context)
+{
+    assert(decoder != nullptr);
+
+    if (callback == nullptr)
+        decoder->m_unreported.clear();
+    else if (decoder->m_decoded_callback == nullptr)
+        reset_reported(decoder);
+
+    decoder->m_decoded_callback = callback;
+    decoder->m_decoded_context = context;
 }
 
 uint8_t krlnc_decoder_is_status_updater_enabled(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.is_status_updater_enabled();
+    return decoder->m_impl->is_status_updater_enabled();
 }
 
 //------------------------------------------------------------------
@@ -201,21 +900,105 @@ uint8_t krlnc_decoder_is_status_updater_enabled(krlnc_decoder_t decoder)
 uint32_t krlnc_decoder_coefficient_vector_size(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    return decoder->m_impl.coefficient_vector_size();
+    return decoder->m_impl->coefficient_vector_size();
 }
 
 void krlnc_decoder_consume_symbol(
     krlnc_decoder_t decoder, uint8_t* symbol_data, uint8_t* coefficients)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.consume_symbol(symbol_data, coefficients);
+    consume(decoder, payload_type::coded, [&]
+    {
+        consume_symbol(decoder, symbol_data, coefficients);
+    });
 }
 
 void krlnc_decoder_consume_systematic_symbol(
     krlnc_decoder_t decoder, uint8_t* symbol_data, uint32_t index)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.consume_systematic_symbol(symbol_data, index);
+    consume(decoder, payload_type::systematic, [&]
+    {
+        consume_systematic_symbol(decoder, symbol_data, index);
+    });
+}
+
+//------------------------------------------------------------------
+// COLUMN THREADS API
+//------------------------------------------------------------------
+
+uint8_t krlnc_decoder_set_column_threads(
+    krlnc_decoder_t decoder, uint32_t threads)
+{
+    assert(decoder != nullptr);
+    assert(state(decoder).rank() == 0);
+
+    if (threads > 1 && decoder->m_uses_payload_api)
+        return 0;
+
+    change_column_threads(decoder, threads);
+    return 1;
+}
+
+uint32_t krlnc_decoder_column_threads(krlnc_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+
+    if (decoder->m_columns == nullptr)
+        return 1;
+
+    return decoder->m_columns->slices();
+}
+
+//------------------------------------------------------------------
+// FEEDBACK API
+//------------------------------------------------------------------
+
+uint32_t krlnc_decoder_feedback_size(krlnc_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return feedback_size(decoder->m_impl->symbols());
+}
+
+uint32_t krlnc_decoder_produce_feedback(
+    krlnc_decoder_t decoder, uint8_t* feedback)
+{
+    assert(decoder != nullptr);
+    assert(feedback != nullptr);
+
+    kodo_rlnc::decoder& impl = state(decoder);
+    uint32_t size = feedback_size(impl.symbols());
+
+    write_uint32(feedback, impl.rank());
+
+    uint8_t* pivots = feedback + sizeof(uint32_t);
+    std::fill(pivots, feedback + size, 0);
+
+    for (uint32_t index = 0; index < impl.symbols(); ++index)
+    {
+        if (impl.is_symbol_pivot(index))
+            pivots[index / 8] |= static_cast<uint8_t>(1 << (index % 8));
+    }
+
+    return size;
+}
+
+//------------------------------------------------------------------
+// STATISTICS API
+//------------------------------------------------------------------
+
+void krlnc_decoder_get_stats(
+    krlnc_decoder_t decoder, krlnc_decoder_stats* stats)
+{
+    assert(decoder != nullptr);
+    assert(stats != nullptr);
+    *stats = decoder->m_stats;
+}
+
+void krlnc_decoder_reset_stats(krlnc_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    decoder->m_stats = krlnc_decoder_stats();
 }
 
 //------------------------------------------------------------------
@@ -225,20 +1008,22 @@ void krlnc_decoder_consume_systematic_symbol(
 void krlnc_decoder_set_seed(krlnc_decoder_t decoder, uint32_t seed_value)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.set_seed(seed_value);
+    decoder->m_impl->set_seed(seed_value);
+    decoder->m_seed = seed_value;
+    decoder->m_has_seed = true;
 }
 
 void krlnc_decoder_generate(krlnc_decoder_t decoder, uint8_t* coefficients)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.generate(coefficients);
+    decoder->m_impl->generate(coefficients);
 }
 
 void krlnc_decoder_generate_partial(
     krlnc_decoder_t decoder, uint8_t* coefficients)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.generate_partial(coefficients);
+    state(decoder).generate_partial(coefficients);
 }
 
 //------------------------------------------------------------------
@@ -248,7 +1033,7 @@ void krlnc_decoder_generate_partial(
 void krlnc_decoder_set_log_stdout(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.set_log_stdout();
+    decoder->m_impl->set_log_stdout();
 }
 
 void krlnc_decoder_set_log_callback(
@@ -262,17 +1047,17 @@ void krlnc_decoder_set_log_callback(
     {
         c_callback(zone.c_str(), data.c_str(), context);
     };
-    decoder->m_impl.set_log_callback(callback);
+    decoder->m_impl->set_log_callback(callback);
 }
 
 void krlnc_decoder_set_log_off(krlnc_decoder_t decoder)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.set_log_off();
+    decoder->m_impl->set_log_off();
 }
 
 void krlnc_decoder_set_zone_prefix(krlnc_decoder_t decoder, const char* prefix)
 {
     assert(decoder != nullptr);
-    decoder->m_impl.set_zone_prefix(std::string(prefix));
+    decoder->m_impl->set_zone_prefix(std::string(prefix));
 }
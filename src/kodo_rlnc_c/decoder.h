@@ -20,6 +20,53 @@ extern "C" {
 /// Opaque pointer used for decoder
 typedef struct krlnc_decoder* krlnc_decoder_t;
 
+/// Callback function type used to report decoded symbols. The function
+/// receives the index of the symbol, the decoded symbol data in the symbol
+/// storage of the decoder and the user-defined context.
+typedef void (*krlnc_symbol_decoded_callback_t)(
+    uint32_t, const uint8_t*, void*);
+
+/// Cumulative statistics of a decoder, see krlnc_decoder_get_stats()
+typedef struct
+{
+    /// The number of payloads and symbols consumed
+    uint64_t payloads_consumed;
+    /// The number of consumed payloads that increased the rank
+    uint64_t innovative_payloads;
+    /// The number of consumed payloads that did not increase the rank
+    uint64_t linearly_dependent_payloads;
+    /// The number of systematic payloads and symbols consumed
+    uint64_t systematic_payloads;
+    /// The number of coded payloads and symbols consumed
+    uint64_t coded_payloads;
+    /// The number of payloads consumed whose type is hidden in the kodo
+    /// payload format, see krlnc_decoder_get_stats()
+    uint64_t unclassified_payloads;
+    /// The estimated number of symbol multiply-add operations, each of
+    /// which processes a full symbol, see krlnc_decoder_get_stats()
+    uint64_t estimated_multiply_add_operations;
+    /// The estimated number of multiply-add operations that were used for
+    /// backward substitution. These are included in
+    /// estimated_multiply_add_operations.
+    uint64_t estimated_backward_substitution_operations;
+}
+krlnc_decoder_stats;
+
+/// The effect of a single consumed payload, see
+/// krlnc_decoder_consume_payload_with_status()
+typedef struct
+{
+    /// Non-zero if the payload increased the rank of the decoder
+    uint8_t innovative;
+    /// Non-zero if the decoder is complete after the payload
+    uint8_t complete;
+    /// The rank of the decoder after the payload
+    uint32_t rank;
+    /// The number of symbols that became decoded due to the payload
+    uint32_t symbols_decoded;
+}
+krlnc_decoder_consume_status;
+
 //------------------------------------------------------------------
 // DECODER BASIC API
 //------------------------------------------------------------------
@@ -43,6 +90,53 @@ void krlnc_delete_decoder(krlnc_decoder_t decoder);
 KODO_RLNC_API
 void krlnc_reset_decoder(krlnc_decoder_t decoder);
 
+/// Reset the decoder and restore the configuration of a new decoder, while
+/// the finite field and the geometry are kept. This switches the column
+/// threads off, removes the symbol decoded callback, restores the status
+/// updater, turns the log off, drops the reconfigure cache, forgets the
+/// symbol storage, unmaps the file storage and clears the statistics. If a
+/// seed was set, the coefficient generator is reseeded with a random seed.
+/// Coder pools call this when a decoder is released, so the next user does
+/// not inherit the settings of the previous one.
+/// @param decoder The decoder to restore
+KODO_RLNC_API
+void krlnc_decoder_restore_defaults(krlnc_decoder_t decoder);
+
+/// Change the number of symbols and the symbol size of the decoder, and reset
+/// it. This is cheaper than creating a new decoder, e.g. for the shorter last
+/// generation of a message. The buffers of the decoder are reused if they are
+/// large enough. The internal coder of the previous geometry is released,
+/// unless krlnc_decoder_set_reconfigure_cache() keeps it for later. The status
+/// updater setting and the decoded symbol callback are kept, while the log
+/// settings only apply to the geometry they were set for. If a seed was set
+/// with krlnc_decoder_set_seed(), the coefficient generator restarts from that
+/// seed, also when the geometry is unchanged. The symbol storage must be
+/// specified again.
+/// @param decoder The decoder which should be reconfigured
+/// @param symbols The new number of symbols
+/// @param symbol_size The new size of a symbol in bytes
+KODO_RLNC_API
+void krlnc_decoder_reconfigure(
+    krlnc_decoder_t decoder, uint32_t symbols, uint32_t symbol_size);
+
+/// Set the number of internal coders of earlier geometries that are kept by
+/// krlnc_decoder_reconfigure(), so switching back to one of these geometries
+/// does not allocate. Every coder holds the state of a full generation, so
+/// the least recently used coder is released when there are more. The
+/// default is 0, which releases the coder of the previous geometry.
+/// @param decoder The decoder to configure
+/// @param coders The maximum number of coders that are kept
+KODO_RLNC_API
+void krlnc_decoder_set_reconfigure_cache(
+    krlnc_decoder_t decoder, uint32_t coders);
+
+/// Return the number of internal coders of earlier geometries that are
+/// kept by krlnc_decoder_reconfigure().
+/// @param decoder The decoder to query
+/// @return The maximum number of coders that are kept
+KODO_RLNC_API
+uint32_t krlnc_decoder_reconfigure_cache(krlnc_decoder_t decoder);
+
 //------------------------------------------------------------------
 // SYMBOL STORAGE API
 //------------------------------------------------------------------
@@ -83,6 +177,26 @@ KODO_RLNC_API
 void krlnc_decoder_set_symbols_storage(
     krlnc_decoder_t decoder, uint8_t* data);
 
+/// Specify a file where the decoded symbols should be stored. The file is
+/// created if it does not exist and extended if it is too short, and the
+/// block_size bytes starting at offset are mapped into memory and used as
+/// the symbol storage. The symbols are decoded directly into the page
+/// cache, and the kernel writes them back to the file. The file stays
+/// mapped until the decoder is deleted or another file is specified.
+/// The file is never shortened, because it may hold other blocks before
+/// or after this one. Memory mapped files are only supported on POSIX
+/// systems.
+/// @param decoder The decoder which will decode the data
+/// @param path The path of the file
+/// @param offset The position of the first symbol in the file
+/// @return Non-zero if the file was mapped, 0 if it could not be opened,
+///         resized or mapped, or if offset + block_size overflows a file
+///         position. If the file is not mapped, the symbol storage is
+///         unchanged.
+KODO_RLNC_API
+uint8_t krlnc_decoder_set_file_storage(
+    krlnc_decoder_t decoder, const char* path, uint64_t offset);
+
 //------------------------------------------------------------------
 // PAYLOAD API
 //------------------------------------------------------------------
@@ -94,7 +208,9 @@ void krlnc_decoder_set_symbols_storage(
 KODO_RLNC_API
 uint32_t krlnc_decoder_max_payload_size(krlnc_decoder_t decoder);
 
-/// Consume an encoded symbol stored in the payload buffer
+/// Consume an encoded symbol stored in the payload buffer. The kodo
+/// payload format cannot be split by column ranges, see
+/// krlnc_decoder_set_column_threads() for how it affects the splitting.
 /// @param decoder The decoder to use.
 /// @param payload The buffer storing the payload of an encoded symbol.
 ///        The payload buffer may be changed by this operation,
@@ -103,10 +219,82 @@ uint32_t krlnc_decoder_max_payload_size(krlnc_decoder_t decoder);
 KODO_RLNC_API
 void krlnc_decoder_consume_payload(krlnc_decoder_t decoder, uint8_t* payload);
 
+/// Consume an encoded symbol like krlnc_decoder_consume_payload(), and
+/// report the effect of the payload. This replaces querying the rank,
+/// completion and symbol status after every payload. A payload that is
+/// dropped because it cannot be split is reported as not innovative.
+/// @param decoder The decoder to use.
+/// @param payload The buffer storing the payload of an encoded symbol.
+///        The payload buffer may be changed by this operation,
+///        so it cannot be reused. If the payload is needed at several places,
+///        make sure to keep a copy of the original payload.
+/// @param status The status to fill
+KODO_RLNC_API
+void krlnc_decoder_consume_payload_with_status(
+    krlnc_decoder_t decoder, uint8_t* payload,
+    krlnc_decoder_consume_status* status);
+
+/// Consume an encoded symbol stored in a read-only payload buffer. This is
+/// a convenience wrapper around krlnc_decoder_consume_payload() which
+/// copies the payload to an internal buffer and decodes the copy, because
+/// kodo decodes a payload in place. It does not avoid a copy, it only
+/// saves the caller from keeping one when the same payload is also
+/// forwarded or given to other decoders.
+/// @param decoder The decoder to use.
+/// @param payload The buffer storing the payload of an encoded symbol.
+/// @param payload_size The size of the payload in bytes, which must not
+///        exceed krlnc_decoder_max_payload_size()
+/// @return Non-zero if the payload was consumed, or 0 if it was dropped
+///         because it cannot be split, see
+///         krlnc_decoder_set_column_threads()
+KODO_RLNC_API
+uint8_t krlnc_decoder_consume_payload_const(
+    krlnc_decoder_t decoder, const uint8_t* payload, uint32_t payload_size);
+
+/// Return the maximum size of a segmented payload, i.e. the size of the
+/// largest header plus the symbol size.
+/// @param decoder The decoder to query.
+/// @return The segmented payload size in bytes
+KODO_RLNC_API
+uint32_t krlnc_decoder_max_segmented_payload_size(krlnc_decoder_t decoder);
+
+/// Consume a payload that was produced as segments with
+/// krlnc_encoder_produce_payload_segments(). Invalid payloads are ignored.
+/// @param decoder The decoder to use.
+/// @param payload The buffer storing the header and symbol segments.
+///        The payload buffer may be changed by this operation,
+///        so it cannot be reused. If the payload is needed at several places,
+///        make sure to keep a copy of the original payload.
+/// @param payload_size The size of the payload in bytes
+KODO_RLNC_API
+void krlnc_decoder_consume_segmented_payload(
+    krlnc_decoder_t decoder, uint8_t* payload, uint32_t payload_size);
+
+/// Consume several encoded payloads stored back-to-back in one buffer, where
+/// each payload starts at a multiple of the stride. This decodes the same
+/// data as calling krlnc_decoder_consume_payload() count times, but the
+/// work that does not depend on a single payload is done once per batch:
+/// if the status updater is on, it runs once after the last payload, and
+/// the symbols that the batch decoded are reported to the symbol decoded
+/// callback after the last payload. The remaining payloads are skipped as
+/// soon as the decoding is complete.
+/// @param decoder The decoder to use.
+/// @param payloads The buffer storing the payloads. The payload buffer may
+///        be changed by this operation, so it cannot be reused.
+/// @param count The number of payloads in the buffer
+/// @param stride The distance in bytes between the start of two consecutive
+///        payloads
+KODO_RLNC_API
+void krlnc_decoder_consume_payloads(
+    krlnc_decoder_t decoder, uint8_t* payloads, uint32_t count,
+    uint32_t stride);
+
 /// Produce a recoded symbol in the provided payload buffer.
 /// @param decoder The decoder to use.
 /// @param payload The buffer which should contain the recoded symbol.
-/// @return The total bytes used from the payload buffer
+/// @return The total bytes used from the payload buffer, or 0 if the
+///         decoding state is split by column ranges, see
+///         krlnc_decoder_set_column_threads()
 KODO_RLNC_API
 uint32_t krlnc_decoder_produce_payload(
     krlnc_decoder_t decoder, uint8_t* payload);
@@ -188,6 +376,27 @@ uint8_t krlnc_decoder_is_symbol_decoded(
 KODO_RLNC_API
 uint8_t krlnc_decoder_is_symbol_pivot(krlnc_decoder_t decoder, uint32_t index);
 
+/// Return the number of 64-bit words needed for a symbol status bitmap,
+/// i.e. (symbols + 63) / 64.
+/// @param decoder The decoder to query
+/// @return The number of words in a bitmap
+KODO_RLNC_API
+uint32_t krlnc_decoder_symbol_status_bitmap_words(krlnc_decoder_t decoder);
+
+/// Take a snapshot of the status of all symbols as packed bitmaps. Bit
+/// (index % 64) of word (index / 64) is set if the symbol with that index
+/// has the status, and the unused bits of the last word are cleared. Each
+/// bitmap is optional, and the bitmaps that are not needed can be NULL.
+/// @param decoder The decoder to query
+/// @param missing The bitmap of missing symbols
+/// @param partially_decoded The bitmap of partially decoded symbols
+/// @param decoded The bitmap of decoded symbols
+/// @param pivot The bitmap of pivot symbols
+KODO_RLNC_API
+void krlnc_decoder_symbol_status_bitmaps(
+    krlnc_decoder_t decoder, uint64_t* missing, uint64_t* partially_decoded,
+    uint64_t* decoded, uint64_t* pivot);
+
 /// Returns whether the symbol status updater is enabled or not.
 /// The status updater can be used to accurately track the status of each
 /// symbol during the decoding process (this can impact the performance).
@@ -208,6 +417,23 @@ void krlnc_decoder_set_status_updater_on(krlnc_decoder_t decoder);
 KODO_RLNC_API
 void krlnc_decoder_set_status_updater_off(krlnc_decoder_t decoder);
 
+/// Register a callback that is invoked once for every symbol as soon as the
+/// decoder labels it as decoded, both for systematic symbols and symbols
+/// that are decoded through elimination. The callback is invoked from the
+/// function that consumed the payload or updated the symbol status, in
+/// the order of the symbol indices. When the status updater is disabled,
+/// symbols decoded through elimination are labelled as decoded once the
+/// decoding is complete or krlnc_decoder_update_symbol_status() is called.
+/// Symbols are reported again after the decoder is reset. The callback
+/// must not consume payloads with the same decoder.
+/// @param decoder The decoder to use
+/// @param callback The callback, or NULL to remove the current callback
+/// @param context A pointer that is passed to the callback
+KODO_RLNC_API
+void krlnc_decoder_set_symbol_decoded_callback(
+    krlnc_decoder_t decoder, krlnc_symbol_decoded_callback_t callback,
+    void* context);
+
 /// Force a manual update on the symbol status so that all symbols that are
 /// currently considered partially decoded will labelled as decoded if their
 /// coding vector only has a single non-zero coefficient (which is 1).
@@ -244,6 +470,117 @@ KODO_RLNC_API
 void krlnc_decoder_consume_systematic_symbol(
     krlnc_decoder_t decoder, uint8_t* symbol_data, uint32_t index);
 
+//------------------------------------------------------------------
+// COLUMN THREADS API
+//------------------------------------------------------------------
+
+/// Split every consumed symbol into column ranges that are decoded
+/// concurrently on a pool of threads. This lowers the latency of a single
+/// payload when the symbols are large, e.g. hundreds of kilobytes. The
+/// splitting applies to krlnc_decoder_consume_symbol(),
+/// krlnc_decoder_consume_systematic_symbol() and
+/// krlnc_decoder_consume_segmented_payload(). Every thread gets at least
+/// 16 KB of a symbol, so fewer threads are used for smaller symbols.
+///
+/// Column threads suit generations with few but large symbols, and they
+/// work with every finite field. For generations with many symbols, e.g.
+/// a thousand or more, most of the work is in the rows of the decoding
+/// matrix rather than in a single symbol, so krlnc_parallel_decoder_t,
+/// which also splits the backward substitution by rows, is the better
+/// choice if the field is krlnc_binary8.
+///
+/// The kodo payload format of krlnc_decoder_consume_payload(), its
+/// variants and krlnc_decoder_produce_payload() cannot be split, so the
+/// two do not mix. Once a decoder has used the kodo payload format, the
+/// column threads cannot be turned on until its defaults are restored
+/// with krlnc_decoder_restore_defaults(). If a kodo payload is used while
+/// the symbols are split and no symbol has been consumed yet, the
+/// splitting is turned off. If symbols have been consumed, their state
+/// cannot be moved out of the column ranges, so this is a usage error and
+/// the payload is dropped.
+///
+/// The number of threads can only be changed while the decoder is empty,
+/// i.e. its rank is 0, such as after it is created or reset. The symbol
+/// storage is kept. The setting and the threads are kept when the decoder
+/// is reset or reconfigured.
+/// @param decoder The decoder to use
+/// @param threads The number of threads, 0 or 1 turns the splitting off
+/// @return Non-zero if the setting was changed, or 0 if the column threads
+///         cannot be turned on because the decoder uses the kodo payload
+///         format
+KODO_RLNC_API
+uint8_t krlnc_decoder_set_column_threads(
+    krlnc_decoder_t decoder, uint32_t threads);
+
+/// Return the number of column ranges that a consumed symbol is split into.
+/// @param decoder The decoder to query
+/// @return The number of column ranges, which is 1 if the symbols are not
+///         split
+KODO_RLNC_API
+uint32_t krlnc_decoder_column_threads(krlnc_decoder_t decoder);
+
+//------------------------------------------------------------------
+// FEEDBACK API
+//------------------------------------------------------------------
+
+/// Return the size of a feedback message.
+/// @param decoder The decoder to query
+/// @return The feedback size in bytes
+KODO_RLNC_API
+uint32_t krlnc_decoder_feedback_size(krlnc_decoder_t decoder);
+
+/// Write a feedback message that describes the rank of the decoder and the
+/// symbols it has a pivot for, using one bit per symbol. The message is
+/// sent back to the encoder, which passes it to
+/// krlnc_encoder_consume_feedback() to stop sending data that the decoder
+/// already has. The encoder only uses the feedback for the segmented wire
+/// format, see krlnc_encoder_consume_feedback().
+/// @param decoder The decoder to query
+/// @param feedback The buffer which should contain the feedback. It must
+///        have a capacity of at least krlnc_decoder_feedback_size() bytes.
+/// @return The total bytes used from the feedback buffer
+KODO_RLNC_API
+uint32_t krlnc_decoder_produce_feedback(
+    krlnc_decoder_t decoder, uint8_t* feedback);
+
+//------------------------------------------------------------------
+// STATISTICS API
+//------------------------------------------------------------------
+
+/// Return the cumulative statistics of a decoder. The counters are updated
+/// by every function that consumes a payload or a symbol, and they are not
+/// cleared when the decoder is reset.
+///
+/// Symbols consumed with krlnc_decoder_consume_symbol() and
+/// krlnc_decoder_consume_systematic_symbol(), and segmented payloads are
+/// counted as systematic or coded. Payloads consumed with
+/// krlnc_decoder_consume_payload() and its variants keep their type in the
+/// header of the kodo payload format, which the decoder cannot read, so
+/// they are counted as unclassified. For those payloads, the systematic
+/// and coded counts of the encoder are available from
+/// krlnc_encoder_get_stats().
+///
+/// kodo-rlnc does not report the operations it performs, so the
+/// multiply-add counts are estimates. The model uses the rank r and the
+/// number of decoded symbols d before each payload, and it assumes dense
+/// coding vectors. A coded payload is reduced with all r pivot rows, and an
+/// innovative payload is substituted back into the r - d partially decoded
+/// rows. A systematic payload needs no reduction. Every operation counts as
+/// one multiply-add of a full symbol, whatever the finite field. With
+/// sparse coding vectors, or when elimination produces zero coefficients,
+/// the actual number of operations is lower. Unclassified payloads are
+/// left out of the estimate, since their cost depends on their type.
+/// @param decoder The decoder to query
+/// @param stats The statistics to fill
+KODO_RLNC_API
+void krlnc_decoder_get_stats(
+    krlnc_decoder_t decoder, krlnc_decoder_stats* stats);
+
+/// Clear the statistics of a decoder.
+/// @param decoder The decoder to use
+KODO_RLNC_API
+void krlnc_decoder_reset_stats(krlnc_decoder_t decoder);
+
 //------------------------------------------------------------------
 // COEFFICIENT GENERATOR API
 //------------------------------------------------------------------
@@ -0,0 +1,83 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include "decoder_pool.h"
+
+#include <cstdint>
+#include <cassert>
+
+#include "detail/coder_pool.hpp"
+
+// The functions that the pool uses to manage its decoders
+struct decoder_functions
+{
+    static krlnc_decoder_t create(
+        int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size)
+    {
+        return krlnc_create_decoder(finite_field_id, symbols, symbol_size);
+    }
+
+    static void destroy(krlnc_decoder_t decoder)
+    {
+        krlnc_delete_decoder(decoder);
+    }
+
+    static void restore_defaults(krlnc_decoder_t decoder)
+    {
+        krlnc_decoder_restore_defaults(decoder);
+    }
+
+    static uint32_t symbols(krlnc_decoder_t decoder)
+    {
+        return krlnc_decoder_symbols(decoder);
+    }
+
+    static uint32_t symbol_size(krlnc_decoder_t decoder)
+    {
+        return krlnc_decoder_symbol_size(decoder);
+    }
+};
+
+struct krlnc_decoder_pool : coder_pool<krlnc_decoder_t, decoder_functions>
+{
+    using coder_pool::coder_pool;
+};
+
+//------------------------------------------------------------------
+// DECODER POOL API
+//------------------------------------------------------------------
+
+krlnc_decoder_pool_t krlnc_create_decoder_pool(
+    int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size,
+    uint32_t decoders)
+{
+    return new krlnc_decoder_pool(
+        finite_field_id, symbols, symbol_size, decoders);
+}
+
+void krlnc_delete_decoder_pool(krlnc_decoder_pool_t pool)
+{
+    assert(pool != nullptr);
+    delete pool;
+}
+
+krlnc_decoder_t krlnc_decoder_pool_acquire(krlnc_decoder_pool_t pool)
+{
+    assert(pool != nullptr);
+    return pool->acquire();
+}
+
+void krlnc_decoder_pool_release(
+    krlnc_decoder_pool_t pool, krlnc_decoder_t decoder)
+{
+    assert(pool != nullptr);
+    pool->release(decoder);
+}
+
+uint32_t krlnc_decoder_pool_available(krlnc_decoder_pool_t pool)
+{
+    assert(pool != nullptr);
+    return pool->available();
+}
@@ -0,0 +1,78 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+#include "decoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------
+// KODO-RLNC-C TYPES
+//------------------------------------------------------------------
+
+/// Opaque pointer used for decoder pool
+typedef struct krlnc_decoder_pool* krlnc_decoder_pool_t;
+
+//------------------------------------------------------------------
+// DECODER POOL API
+//------------------------------------------------------------------
+
+/// Create a new decoder pool. The pool hands out decoders that share the same
+/// finite field, number of symbols and symbol size. Released decoders are
+/// reset and kept for later use, so acquiring and releasing a decoder does not
+/// allocate memory once the pool is warm. A pool is not thread-safe, so
+/// each thread should use its own pool.
+/// @param finite_field_id The finite field that should be used.
+/// @param symbols The number of symbols in a coding block
+/// @param symbol_size The size of a symbol in bytes
+/// @param decoders The number of decoders that are created up front
+/// @return Pointer to a new decoder pool instance.
+KODO_RLNC_API
+krlnc_decoder_pool_t krlnc_create_decoder_pool(
+    int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size,
+    uint32_t decoders);
+
+/// Deallocate and release the memory consumed by a decoder pool, including
+/// all the decoders kept in the pool. All acquired decoders must be released
+/// before the pool is deleted.
+/// @param pool The decoder pool which should be deallocated
+KODO_RLNC_API
+void krlnc_delete_decoder_pool(krlnc_decoder_pool_t pool);
+
+/// Acquire a decoder from the pool. A new decoder is created if the pool is
+/// empty.
+/// @param pool The decoder pool to use
+/// @return A decoder in a clean state
+KODO_RLNC_API
+krlnc_decoder_t krlnc_decoder_pool_acquire(krlnc_decoder_pool_t pool);
+
+/// Release a decoder back to the pool. The decoder is reset and gets the
+/// configuration of a new decoder back, see
+/// krlnc_decoder_restore_defaults(), so the next user does not inherit
+/// callbacks, seeds or other settings. A decoder that was reconfigured to
+/// another geometry is deleted instead of being kept.
+/// @param pool The decoder pool to use
+/// @param decoder The decoder to release, which must have been acquired from
+///        this pool
+KODO_RLNC_API
+void krlnc_decoder_pool_release(
+    krlnc_decoder_pool_t pool, krlnc_decoder_t decoder);
+
+/// Return the number of decoders that are ready to be acquired without
+/// allocating memory.
+/// @param pool The decoder pool to query
+/// @return The number of decoders in the pool
+KODO_RLNC_API
+uint32_t krlnc_decoder_pool_available(krlnc_decoder_pool_t pool);
+
+#ifdef __cplusplus
+}
+#endif
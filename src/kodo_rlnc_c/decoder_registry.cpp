@@ -0,0 +1,341 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include "decoder_registry.h"
+#include "decoder_pool.h"
+
+#include <cstdint>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+// Marks the end of the recently used list
+static const uint32_t no_slot = 0xFFFFFFFFU;
+
+struct krlnc_decoder_registry
+{
+    // A slot holds the decoder and the data buffer of a flow. The used
+    // slots are linked from the most to the least recently used.
+    struct slot
+    {
+        uint64_t m_flow_id = 0;
+        krlnc_decoder_t m_decoder = nullptr;
+        uint32_t m_newer = no_slot;
+        uint32_t m_older = no_slot;
+    };
+
+    krlnc_decoder_pool_t m_pool = nullptr;
+
+    uint64_t m_block_size = 0;
+    uint32_t m_capacity = 0;
+    uint32_t m_flows = 0;
+    uint64_t m_evictions = 0;
+
+    std::vector<slot> m_slots;
+    std::vector<uint32_t> m_free;
+    std::unique_ptr<uint8_t[]> m_data;
+
+    // The open addressing index with linear probing. An entry holds the
+    // slot of a flow plus one, so zero marks an empty entry.
+    std::vector<uint32_t> m_index;
+    uint32_t m_index_mask = 0;
+
+    uint32_t m_newest = no_slot;
+    uint32_t m_oldest = no_slot;
+
+    krlnc_flow_evicted_callback_t m_eviction_callback = nullptr;
+    void* m_eviction_context = nullptr;
+};
+
+// The flow ids are often sequential, so the bits are mixed before they are
+// used as an index position
+static uint32_t home_position(krlnc_decoder_registry_t registry,
+                              uint64_t flow_id)
+{
+    flow_id ^= flow_id >> 30;
+    flow_id *= 0xBF58476D1CE4E5B9ULL;
+    flow_id ^= flow_id >> 27;
+    flow_id *= 0x94D049BB133111EBULL;
+    flow_id ^= flow_id >> 31;
+    return static_cast<uint32_t>(flow_id) & registry->m_index_mask;
+}
+
+// Return the index position of a flow, or of the empty entry where the
+// flow would be inserted
+static uint32_t find_position(krlnc_decoder_registry_t registry,
+                              uint64_t flow_id)
+{
+    uint32_t position = home_position(registry, flow_id);
+    while (registry->m_index[position] != 0)
+    {
+        uint32_t slot = registry->m_index[position] - 1;
+        if (registry->m_slots[slot].m_flow_id == flow_id)
+            break;
+
+        position = (position + 1) & registry->m_index_mask;
+    }
+    return position;
+}
+
+static uint32_t find_slot(krlnc_decoder_registry_t registry, uint64_t flow_id)
+{
+    uint32_t entry = registry->m_index[find_position(registry, flow_id)];
+    return entry == 0 ? no_slot : entry - 1;
+}
+
+// Clear an index entry and shift the following entries of the probe
+// sequence back, so lookups never need tombstones
+static void erase_position(krlnc_decoder_registry_t registry,
+                           uint32_t position)
+{
+    uint32_t mask = registry->m_index_mask;
+    uint32_t hole = position;
+    registry->m_index[hole] = 0;
+
+    for (uint32_t next = (hole + 1) & mask; registry->m_index[next] != 0;
+         next = (next + 1) & mask)
+    {
+        uint32_t slot = registry->m_index[next] - 1;
+        uint32_t home = home_position(
+            registry, registry->m_slots[slot].m_flow_id);
+
+        // The entry stays if its home lies cyclically in (hole, next]
+        if (((next - home) & mask) < ((next - hole) & mask))
+            continue;
+
+        registry->m_index[hole] = registry->m_index[next];
+        registry->m_index[next] = 0;
+        hole = next;
+    }
+}
+
+static void unlink_slot(krlnc_decoder_registry_t registry, uint32_t index)
+{
+    auto& slot = registry->m_slots[index];
+
+    if (slot.m_newer != no_slot)
+        registry->m_slots[slot.m_newer].m_older = slot.m_older;
+    else
+        registry->m_newest = slot.m_older;
+
+    if (slot.m_older != no_slot)
+        registry->m_slots[slot.m_older].m_newer = slot.m_newer;
+    else
+        registry->m_oldest = slot.m_newer;
+
+    slot.m_newer = no_slot;
+    slot.m_older = no_slot;
+}
+
+static void link_newest(krlnc_decoder_registry_t registry, uint32_t index)
+{
+    auto& slot = registry->m_slots[index];
+    slot.m_newer = no_slot;
+    slot.m_older = registry->m_newest;
+
+    if (registry->m_newest != no_slot)
+        registry->m_slots[registry->m_newest].m_newer = index;
+    else
+        registry->m_oldest = index;
+
+    registry->m_newest = index;
+}
+
+static uint8_t* slot_data(krlnc_decoder_registry_t registry, uint32_t index)
+{
+    return registry->m_data.get() + index * registry->m_block_size;
+}
+
+// Remove the flow in a slot and recycle its decoder and data buffer
+static void release_slot(krlnc_decoder_registry_t registry, uint32_t index)
+{
+    auto& slot = registry->m_slots[index];
+
+    erase_position(registry, find_position(registry, slot.m_flow_id));
+    unlink_slot(registry, index);
+
+    krlnc_decoder_pool_release(registry->m_pool, slot.m_decoder);
+    slot.m_decoder = nullptr;
+
+    registry->m_free.push_back(index);
+    --registry->m_flows;
+}
+
+//------------------------------------------------------------------
+// DECODER REGISTRY API
+//------------------------------------------------------------------
+
+krlnc_decoder_registry_t krlnc_create_decoder_registry(
+    int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size,
+    uint64_t memory_budget)
+{
+    auto registry = new krlnc_decoder_registry();
+    registry->m_pool = krlnc_create_decoder_pool(
+        finite_field_id, symbols, symbol_size, 1);
+
+    // Use the first decoder to find the memory needed by a flow
+    krlnc_decoder_t decoder = krlnc_decoder_pool_acquire(registry->m_pool);
+    registry->m_block_size = krlnc_decoder_block_size(decoder);
+    uint64_t flow_size = registry->m_block_size +
+        uint64_t{symbols} * krlnc_decoder_coefficient_vector_size(decoder);
+    krlnc_decoder_pool_release(registry->m_pool, decoder);
+
+    uint64_t capacity = memory_budget / flow_size;
+    if (capacity == 0)
+        capacity = 1;
+    if (capacity > (1U << 30))
+        capacity = 1U << 30;
+    registry->m_capacity = static_cast<uint32_t>(capacity);
+
+    registry->m_slots.resize(registry->m_capacity);
+    registry->m_free.reserve(registry->m_capacity);
+    for (uint32_t i = registry->m_capacity; i > 0; --i)
+        registry->m_free.push_back(i - 1);
+
+    // The data is not initialized, so the pages are only committed once a
+    // slot is used
+    registry->m_data.reset(
+        new uint8_t[registry->m_capacity * registry->m_block_size]);
+
+    // Keep the index at most half full, so the probe sequences stay short
+    uint32_t index_size = 2;
+    while (index_size < 2 * registry->m_capacity)
+        index_size *= 2;
+
+    registry->m_index.resize(index_size, 0);
+    registry->m_index_mask = index_size - 1;
+
+    return registry;
+}
+
+void krlnc_delete_decoder_registry(krlnc_decoder_registry_t registry)
+{
+    assert(registry != nullptr);
+
+    while (registry->m_newest != no_slot)
+        release_slot(registry, registry->m_newest);
+
+    krlnc_delete_decoder_pool(registry->m_pool);
+    delete registry;
+}
+
+uint32_t krlnc_decoder_registry_capacity(krlnc_decoder_registry_t registry)
+{
+    assert(registry != nullptr);
+    return registry->m_capacity;
+}
+
+uint32_t krlnc_decoder_registry_flows(krlnc_decoder_registry_t registry)
+{
+    assert(registry != nullptr);
+    return registry->m_flows;
+}
+
+uint64_t krlnc_decoder_registry_evictions(krlnc_decoder_registry_t registry)
+{
+    assert(registry != nullptr);
+    return registry->m_evictions;
+}
+
+void krlnc_decoder_registry_set_eviction_callback(
+    krlnc_decoder_registry_t registry,
+    krlnc_flow_evicted_callback_t callback, void* context)
+{
+    assert(registry != nullptr);
+    registry->m_eviction_callback = callback;
+    registry->m_eviction_context = context;
+}
+
+krlnc_decoder_t krlnc_decoder_registry_consume_payload(
+    krlnc_decoder_registry_t registry, uint64_t flow_id, uint8_t* payload)
+{
+    assert(registry != nullptr);
+    assert(payload != nullptr);
+
+    uint32_t position = find_position(registry, flow_id);
+    uint32_t index = 0;
+
+    if (registry->m_index[position] != 0)
+    {
+        index = registry->m_index[position] - 1;
+
+        if (registry->m_newest != index)
+        {
+            unlink_slot(registry, index);
+            link_newest(registry, index);
+        }
+    }
+    else
+    {
+        if (registry->m_free.empty())
+        {
+            uint32_t oldest = registry->m_oldest;
+            auto& slot = registry->m_slots[oldest];
+
+            if (registry->m_eviction_callback != nullptr)
+            {
+                registry->m_eviction_callback(
+                    slot.m_flow_id, slot.m_decoder, slot_data(registry, oldest),
+                    registry->m_eviction_context);
+            }
+
+            release_slot(registry, oldest);
+            ++registry->m_evictions;
+
+            // The eviction may have shifted the empty entry
+            position = find_position(registry, flow_id);
+        }
+
+        index = registry->m_free.back();
+        registry->m_free.pop_back();
+
+        auto& slot = registry->m_slots[index];
+        slot.m_flow_id = flow_id;
+        slot.m_decoder = krlnc_decoder_pool_acquire(registry->m_pool);
+        krlnc_decoder_set_symbols_storage(
+            slot.m_decoder, slot_data(registry, index));
+
+        registry->m_index[position] = index + 1;
+        link_newest(registry, index);
+        ++registry->m_flows;
+    }
+
+    krlnc_decoder_t decoder = registry->m_slots[index].m_decoder;
+    if (!krlnc_decoder_is_complete(decoder))
+        krlnc_decoder_consume_payload(decoder, payload);
+
+    return decoder;
+}
+
+krlnc_decoder_t krlnc_decoder_registry_find(
+    krlnc_decoder_registry_t registry, uint64_t flow_id)
+{
+    assert(registry != nullptr);
+
+    uint32_t index = find_slot(registry, flow_id);
+    return index == no_slot ? nullptr : registry->m_slots[index].m_decoder;
+}
+
+const uint8_t* krlnc_decoder_registry_flow_data(
+    krlnc_decoder_registry_t registry, uint64_t flow_id)
+{
+    assert(registry != nullptr);
+
+    uint32_t index = find_slot(registry, flow_id);
+    return index == no_slot ? nullptr : slot_data(registry, index);
+}
+
+uint8_t krlnc_decoder_registry_remove(
+    krlnc_decoder_registry_t registry, uint64_t flow_id)
+{
+    assert(registry != nullptr);
+
+    uint32_t index = find_slot(registry, flow_id);
+    if (index == no_slot)
+        return 0;
+
+    release_slot(registry, index);
+    return 1;
+}
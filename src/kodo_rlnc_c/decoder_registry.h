@@ -0,0 +1,136 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+#include "decoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------
+// KODO-RLNC-C TYPES
+//------------------------------------------------------------------
+
+/// Opaque pointer used for decoder registry
+typedef struct krlnc_decoder_registry* krlnc_decoder_registry_t;
+
+/// Callback function type used to report evicted flows. The function
+/// receives the flow id, the decoder of the flow, the decoded data of the
+/// flow and the user-defined context. The decoder and the data are recycled
+/// when the callback returns.
+typedef void (*krlnc_flow_evicted_callback_t)(
+    uint64_t, krlnc_decoder_t, const uint8_t*, void*);
+
+//------------------------------------------------------------------
+// DECODER REGISTRY API
+//------------------------------------------------------------------
+
+/// Create a new decoder registry. The registry keeps a decoder for each
+/// flow, which is identified by a 64-bit id, e.g. a flow and generation
+/// number. All decoders share the same finite field, number of symbols and
+/// symbol size, and the registry owns the data buffers of the decoders.
+///
+/// The number of flows is bounded by the memory budget, which covers the
+/// data and the coefficients of every decoder. The registry allocates its
+/// index and data buffers up front, and it recycles the decoders of removed
+/// flows, so no memory is allocated once every flow slot has been used.
+/// When a payload arrives for a new flow and the registry is full, the
+/// least recently used flow is evicted. A registry is not thread-safe.
+/// @param finite_field_id The finite field that should be used.
+/// @param symbols The number of symbols in a coding block
+/// @param symbol_size The size of a symbol in bytes
+/// @param memory_budget The memory budget in bytes. At least one flow is
+///        allowed, even if the budget is smaller than a single decoder.
+/// @return Pointer to a new decoder registry instance.
+KODO_RLNC_API
+krlnc_decoder_registry_t krlnc_create_decoder_registry(
+    int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size,
+    uint64_t memory_budget);
+
+/// Deallocate and release the memory consumed by a decoder registry,
+/// including all the decoders and their data. The eviction callback is not
+/// invoked for the remaining flows.
+/// @param registry The decoder registry which should be deallocated
+KODO_RLNC_API
+void krlnc_delete_decoder_registry(krlnc_decoder_registry_t registry);
+
+/// Return the maximum number of flows that fit in the memory budget.
+/// @param registry The decoder registry to query
+/// @return The maximum number of flows
+KODO_RLNC_API
+uint32_t krlnc_decoder_registry_capacity(krlnc_decoder_registry_t registry);
+
+/// Return the number of flows that currently have a decoder.
+/// @param registry The decoder registry to query
+/// @return The number of flows
+KODO_RLNC_API
+uint32_t krlnc_decoder_registry_flows(krlnc_decoder_registry_t registry);
+
+/// Return the number of flows that were evicted to make room for new flows.
+/// @param registry The decoder registry to query
+/// @return The number of evicted flows
+KODO_RLNC_API
+uint64_t krlnc_decoder_registry_evictions(krlnc_decoder_registry_t registry);
+
+/// Register a callback that is invoked when a flow is evicted, so partially
+/// decoded data can be salvaged before it is recycled. The callback is not
+/// invoked for flows that are removed with
+/// krlnc_decoder_registry_remove().
+/// @param registry The decoder registry to use
+/// @param callback The callback, or NULL to remove the current callback
+/// @param context A pointer that is passed to the callback
+KODO_RLNC_API
+void krlnc_decoder_registry_set_eviction_callback(
+    krlnc_decoder_registry_t registry,
+    krlnc_flow_evicted_callback_t callback, void* context);
+
+/// Consume a payload for a flow. The decoder of the flow is looked up, or
+/// created if the flow is new, and the flow becomes the most recently used.
+/// The payload is not consumed if the decoder is already complete.
+/// @param registry The decoder registry to use
+/// @param flow_id The id of the flow that the payload belongs to
+/// @param payload The buffer storing the payload of an encoded symbol.
+///        The payload buffer may be changed by this operation,
+///        so it cannot be reused. If the payload is needed at several places,
+///        make sure to keep a copy of the original payload.
+/// @return The decoder of the flow, which is owned by the registry
+KODO_RLNC_API
+krlnc_decoder_t krlnc_decoder_registry_consume_payload(
+    krlnc_decoder_registry_t registry, uint64_t flow_id, uint8_t* payload);
+
+/// Look up the decoder of a flow without changing the order of the flows.
+/// @param registry The decoder registry to query
+/// @param flow_id The id of the flow
+/// @return The decoder of the flow, or NULL if the flow is unknown
+KODO_RLNC_API
+krlnc_decoder_t krlnc_decoder_registry_find(
+    krlnc_decoder_registry_t registry, uint64_t flow_id);
+
+/// Return the data buffer of a flow, which holds the decoded symbols.
+/// @param registry The decoder registry to query
+/// @param flow_id The id of the flow
+/// @return The data of the flow, or NULL if the flow is unknown. The buffer
+///         is valid until the flow is removed or evicted.
+KODO_RLNC_API
+const uint8_t* krlnc_decoder_registry_flow_data(
+    krlnc_decoder_registry_t registry, uint64_t flow_id);
+
+/// Remove a flow, e.g. after its data has been delivered. The decoder and
+/// the data buffer of the flow are recycled for new flows.
+/// @param registry The decoder registry to use
+/// @param flow_id The id of the flow
+/// @return Non-zero if the flow was found and removed
+KODO_RLNC_API
+uint8_t krlnc_decoder_registry_remove(
+    krlnc_decoder_registry_t registry, uint64_t flow_id);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,86 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <kodo_rlnc/coders.hpp>
+
+/// The coders that were recently replaced by a reconfiguration, so a coder
+/// can switch back to one of these geometries without allocating. The
+/// least recently used coder is released when the cache is full. No coders
+/// are kept by default, since every coder holds the state of a full
+/// generation.
+template<class Coder>
+class coder_cache
+{
+public:
+
+    /// Set the maximum number of coders that are kept, and release the
+    /// least recently used coders that do not fit
+    void set_max_coders(uint32_t max_coders)
+    {
+        m_max_coders = max_coders;
+
+        if (m_coders.size() > max_coders)
+        {
+            m_coders.erase(m_coders.begin(), m_coders.end() - max_coders);
+        }
+    }
+
+    /// @return The maximum number of coders that are kept
+    uint32_t max_coders() const
+    {
+        return m_max_coders;
+    }
+
+    /// Replace a coder with one of the given geometry. A cached coder with
+    /// the geometry is reused, otherwise a new coder is created. The
+    /// replaced coder is added to the cache, or released if the cache
+    /// keeps no coders.
+    void select(std::unique_ptr<Coder>& coder, fifi::finite_field field,
+                uint32_t symbols, uint32_t symbol_size)
+    {
+        auto match = std::find_if(m_coders.begin(), m_coders.end(),
+            [&](const std::unique_ptr<Coder>& cached)
+            {
+                return cached->symbols() == symbols &&
+                       cached->symbol_size() == symbol_size;
+            });
+
+        std::unique_ptr<Coder> selected;
+        if (match != m_coders.end())
+        {
+            selected = std::move(*match);
+            m_coders.erase(match);
+        }
+        else
+        {
+            selected.reset(new Coder(field, symbols, symbol_size));
+        }
+
+        if (m_max_coders > 0)
+        {
+            if (m_coders.size() == m_max_coders)
+                m_coders.erase(m_coders.begin());
+
+            m_coders.reserve(m_max_coders);
+            m_coders.push_back(std::move(coder));
+        }
+
+        coder = std::move(selected);
+    }
+
+private:
+
+    uint32_t m_max_coders = 0;
+
+    // The cached coders, ordered from the least to the most recently used
+    std::vector<std::unique_ptr<Coder>> m_coders;
+};
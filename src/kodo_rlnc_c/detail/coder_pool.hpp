@@ -0,0 +1,104 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+/// A pool of coders that share the same finite field, number of symbols and
+/// symbol size. Released coders get the configuration of a new coder back
+/// and are kept for later use.
+///
+/// The coders are handles of the C API, and Functions provides the static
+/// functions create(), destroy(), restore_defaults(), symbols() and
+/// symbol_size() that operate on them.
+template<class Coder, class Functions>
+class coder_pool
+{
+public:
+
+    /// Create a pool with the given number of coders up front
+    coder_pool(int32_t finite_field_id, uint32_t symbols,
+               uint32_t symbol_size, uint32_t coders) :
+        m_finite_field_id(finite_field_id),
+        m_symbols(symbols),
+        m_symbol_size(symbol_size)
+    {
+        m_free.reserve(coders);
+        for (uint32_t i = 0; i < coders; ++i)
+        {
+            m_free.push_back(Functions::create(
+                finite_field_id, symbols, symbol_size));
+        }
+    }
+
+    ~coder_pool()
+    {
+        assert(m_acquired == 0);
+
+        for (Coder coder : m_free)
+            Functions::destroy(coder);
+    }
+
+    coder_pool(const coder_pool&) = delete;
+    coder_pool& operator=(const coder_pool&) = delete;
+
+    /// @return A coder from the pool, or a new coder if the pool is empty
+    Coder acquire()
+    {
+        ++m_acquired;
+
+        if (m_free.empty())
+        {
+            return Functions::create(
+                m_finite_field_id, m_symbols, m_symbol_size);
+        }
+
+        Coder coder = m_free.back();
+        m_free.pop_back();
+        return coder;
+    }
+
+    /// Restore the default configuration of a coder that was acquired from
+    /// this pool and keep it. A coder that was reconfigured to another
+    /// geometry is deleted instead, since it no longer matches the pool.
+    void release(Coder coder)
+    {
+        assert(coder != nullptr);
+        assert(m_acquired > 0);
+
+        --m_acquired;
+
+        if (Functions::symbols(coder) != m_symbols ||
+            Functions::symbol_size(coder) != m_symbol_size)
+        {
+            Functions::destroy(coder);
+            return;
+        }
+
+        Functions::restore_defaults(coder);
+        m_free.push_back(coder);
+    }
+
+    /// @return The number of coders that can be acquired without
+    ///         allocating
+    uint32_t available() const
+    {
+        return static_cast<uint32_t>(m_free.size());
+    }
+
+private:
+
+    int32_t m_finite_field_id;
+    uint32_t m_symbols;
+    uint32_t m_symbol_size;
+
+    // The number of coders that are acquired and not yet released
+    uint32_t m_acquired = 0;
+
+    std::vector<Coder> m_free;
+};
@@ -0,0 +1,76 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include <kodo_rlnc/coders.hpp>
+
+// A full coefficient vector stores the coefficients packed according to the
+// field. A binary coefficient is bit index % 8 of byte index / 8, a binary4
+// coefficient is the low nibble of byte index / 2 for an even index and the
+// high nibble for an odd index, and a binary16 coefficient is a 16-bit
+// integer in host byte order.
+
+/// @return The coefficient of a symbol in a full coefficient vector
+inline uint32_t coefficient_value(
+    fifi::finite_field field, const uint8_t* coefficients, uint32_t index)
+{
+    switch (field)
+    {
+    case fifi::finite_field::binary:
+        return (coefficients[index / 8] >> (index % 8)) & 0x1;
+    case fifi::finite_field::binary4:
+        return (coefficients[index / 2] >> (4 * (index % 2))) & 0xF;
+    case fifi::finite_field::binary8:
+        return coefficients[index];
+    case fifi::finite_field::binary16:
+    {
+        uint16_t value;
+        std::memcpy(&value, coefficients + 2 * index, sizeof(value));
+        return value;
+    }
+    default:
+        return 0;
+    }
+}
+
+/// Set the coefficient of a symbol in a full coefficient vector
+inline void set_coefficient_value(
+    fifi::finite_field field, uint8_t* coefficients, uint32_t index,
+    uint32_t value)
+{
+    switch (field)
+    {
+    case fifi::finite_field::binary:
+    {
+        uint8_t mask = static_cast<uint8_t>(1 << (index % 8));
+        coefficients[index / 8] = static_cast<uint8_t>(
+            (coefficients[index / 8] & ~mask) | (value & 0x1 ? mask : 0));
+        break;
+    }
+    case fifi::finite_field::binary4:
+    {
+        uint32_t shift = 4 * (index % 2);
+        coefficients[index / 2] = static_cast<uint8_t>(
+            (coefficients[index / 2] & ~(0xF << shift)) |
+            (value & 0xF) << shift);
+        break;
+    }
+    case fifi::finite_field::binary8:
+        coefficients[index] = static_cast<uint8_t>(value);
+        break;
+    case fifi::finite_field::binary16:
+    {
+        uint16_t element = static_cast<uint16_t>(value);
+        std::memcpy(coefficients + 2 * index, &element, sizeof(element));
+        break;
+    }
+    default:
+        break;
+    }
+}
@@ -0,0 +1,118 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <kodo_rlnc/coders.hpp>
+
+#include "thread_pool.hpp"
+
+/// A set of coders that each cover a range of columns of the same symbols,
+/// so a single symbol operation can be split across a thread pool. The
+/// pool is owned by the caller, so it outlives the slices when they are
+/// rebuilt for a new geometry.
+///
+/// Every slice is a coder with the full number of symbols and a symbol
+/// size equal to the width of its column range. The coefficients are the
+/// same for every column, so all slices perform the same operations and
+/// their state is identical, only the symbol data differs.
+template<class Coder>
+class column_slices
+{
+public:
+
+    /// The smallest column range that is given to a thread. Narrower
+    /// ranges would spend more time on waking the threads than on coding.
+    static const uint32_t min_slice_size = 16384;
+
+    /// The column ranges start at a multiple of this alignment
+    static const uint32_t slice_alignment = 64;
+
+    /// @return The number of slices that a symbol size is split into with
+    ///         the given number of threads. There is no point in splitting
+    ///         if it is less than two.
+    static uint32_t slice_count(uint32_t symbol_size, uint32_t threads)
+    {
+        return std::max<uint32_t>(
+            1, std::min(threads, symbol_size / min_slice_size));
+    }
+
+    column_slices(fifi::finite_field field, uint32_t symbols,
+                  uint32_t symbol_size, thread_pool& pool) :
+        m_pool(pool)
+    {
+        uint32_t slices = slice_count(symbol_size, pool.threads());
+
+        for (uint32_t i = 0; i <= slices; ++i)
+        {
+            uint64_t column = uint64_t{symbol_size} * i / slices;
+            m_offsets.push_back(i == slices ? symbol_size :
+                static_cast<uint32_t>(column / slice_alignment *
+                                      slice_alignment));
+        }
+
+        for (uint32_t i = 0; i < slices; ++i)
+        {
+            m_coders.emplace_back(new Coder(
+                field, symbols, m_offsets[i + 1] - m_offsets[i]));
+        }
+    }
+
+    /// @return The number of slices
+    uint32_t slices() const
+    {
+        return static_cast<uint32_t>(m_coders.size());
+    }
+
+    /// @return The coder of a slice
+    Coder& coder(uint32_t slice)
+    {
+        return *m_coders[slice];
+    }
+
+    /// @return The first column of a slice
+    uint32_t offset(uint32_t slice) const
+    {
+        return m_offsets[slice];
+    }
+
+    /// Set the storage of a full symbol, every slice uses its own columns
+    void set_symbol_storage(uint8_t* data, uint32_t index)
+    {
+        for (uint32_t i = 0; i < slices(); ++i)
+            m_coders[i]->set_symbol_storage(data + m_offsets[i], index);
+    }
+
+    /// Reset the coders of all slices
+    void reset()
+    {
+        for (auto& coder : m_coders)
+            coder->reset();
+    }
+
+    /// Run function(slice) for every slice on the thread pool and block
+    /// until all slices are done
+    template<class Function>
+    void run(Function&& function)
+    {
+        m_pool.run_and_wait(slices(), [&](uint32_t, uint32_t slice)
+        {
+            function(slice);
+        });
+    }
+
+private:
+
+    thread_pool& m_pool;
+    std::vector<std::unique_ptr<Coder>> m_coders;
+
+    // The first column of every slice, followed by the symbol size
+    std::vector<uint32_t> m_offsets;
+};
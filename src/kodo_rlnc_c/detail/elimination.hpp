@@ -0,0 +1,99 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include <fifi/math.hpp>
+
+/// The row operations of Gaussian elimination over a finite field, for the
+/// coders that keep their own decoding matrix instead of a kodo coder. The
+/// arithmetic is done by fifi, which uses the fastest vector instructions
+/// of the CPU.
+///
+/// A row is a coding vector with one coefficient per byte, followed by a
+/// symbol. The two parts may be stored apart, so the operations take them
+/// separately. Only the binary8 field stores one coefficient per byte, so
+/// it is the only field that is supported.
+class elimination
+{
+public:
+
+    elimination() :
+        m_math(fifi::finite_field::binary8)
+    { }
+
+    /// @return The product of two elements
+    uint8_t multiply(uint8_t a, uint8_t b) const
+    {
+        return static_cast<uint8_t>(m_math.multiply(a, b));
+    }
+
+    /// @return The inverse of a non-zero element
+    uint8_t invert(uint8_t a) const
+    {
+        assert(a != 0);
+        return static_cast<uint8_t>(m_math.invert(a));
+    }
+
+    /// Compute dest[i] = dest[i] + constant * src[i]. Addition and
+    /// subtraction are the same in a binary extension field, so this also
+    /// subtracts a multiple of a row.
+    void multiply_add(uint8_t* dest, const uint8_t* src, uint8_t constant,
+                      uint32_t size) const
+    {
+        if (constant == 0 || size == 0)
+            return;
+
+        m_math.vector_multiply_add_into(dest, src, constant, size);
+    }
+
+    /// Compute data[i] = constant * data[i]
+    void multiply(uint8_t* data, uint8_t constant, uint32_t size) const
+    {
+        if (constant == 1 || size == 0)
+            return;
+
+        m_math.vector_multiply_into(data, constant, size);
+    }
+
+    /// Subtract a multiple of a row from another row
+    void subtract_row(uint8_t* coefficients, uint8_t* symbol,
+                      const uint8_t* row_coefficients,
+                      const uint8_t* row_symbol, uint8_t multiplier,
+                      uint32_t coefficients_size, uint32_t symbol_size) const
+    {
+        multiply_add(coefficients, row_coefficients, multiplier,
+                     coefficients_size);
+        multiply_add(symbol, row_symbol, multiplier, symbol_size);
+    }
+
+    /// Scale a row so its pivot coefficient becomes one
+    void normalize_row(uint8_t* coefficients, uint8_t* symbol,
+                       uint32_t pivot, uint32_t coefficients_size,
+                       uint32_t symbol_size) const
+    {
+        uint8_t inverse = invert(coefficients[pivot]);
+        multiply(coefficients, inverse, coefficients_size);
+        multiply(symbol, inverse, symbol_size);
+    }
+
+    /// @return The index of the first non-zero coefficient from begin, or
+    ///         end if there is none
+    static uint32_t find_pivot(const uint8_t* coefficients, uint32_t begin,
+                               uint32_t end)
+    {
+        while (begin < end && coefficients[begin] == 0)
+            ++begin;
+
+        return begin;
+    }
+
+private:
+
+    fifi::math m_math;
+};
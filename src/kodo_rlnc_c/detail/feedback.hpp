@@ -0,0 +1,27 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+// A feedback message starts with the rank of the decoder as a 32-bit
+// little-endian integer, see write_uint32(). It continues with a bitmap
+// that has one bit per symbol, where bit index % 8 of byte index / 8 is set
+// if the decoder has a pivot for the symbol.
+
+/// @param symbols The number of symbols
+/// @return The size of a feedback message
+inline uint32_t feedback_size(uint32_t symbols)
+{
+    return sizeof(uint32_t) + (symbols + 7) / 8;
+}
+
+/// @return True if the feedback has a pivot for the symbol
+inline bool feedback_has_pivot(const uint8_t* feedback, uint32_t index)
+{
+    const uint8_t* pivots = feedback + sizeof(uint32_t);
+    return (pivots[index / 8] >> (index % 8)) & 0x1;
+}
@@ -0,0 +1,220 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+/// A memory mapping of a part of a file, which is unmapped when the
+/// mapping is destroyed or another part is mapped. If an open function
+/// fails, the current mapping is kept.
+///
+/// The mapped pages are used directly as symbol storage, so the data is
+/// read from or written to the page cache without an intermediate buffer.
+/// The kernel is told that the pages are accessed sequentially, which
+/// enables aggressive read-ahead and lets it drop pages behind the coder.
+/// Memory mapped files are only supported on POSIX systems, elsewhere the
+/// open functions fail.
+class file_mapping
+{
+public:
+
+    file_mapping() = default;
+
+    file_mapping(const file_mapping&) = delete;
+    file_mapping& operator=(const file_mapping&) = delete;
+
+    ~file_mapping()
+    {
+        close();
+    }
+
+    /// Map size bytes of an existing file for reading, starting at offset.
+    /// Fails if the file is shorter than offset + size, or if that end
+    /// position cannot be represented.
+    bool open_read(const char* path, uint64_t offset, uint64_t size)
+    {
+#if !defined(_WIN32)
+        if (!is_valid_range(offset, size))
+            return false;
+
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        bool ok = ::fstat(fd, &info) == 0 &&
+                  offset + size <= static_cast<uint64_t>(info.st_size) &&
+                  map(fd, offset, size, PROT_READ);
+        ::close(fd);
+
+        // A single block is small, so it is read ahead right away
+        if (ok)
+        {
+            advise(MADV_SEQUENTIAL);
+            advise(MADV_WILLNEED);
+        }
+        return ok;
+#else
+        (void) path; (void) offset; (void) size;
+        return false;
+#endif
+    }
+
+    /// Map a whole existing file for reading
+    bool open_read(const char* path)
+    {
+#if !defined(_WIN32)
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        bool ok = ::fstat(fd, &info) == 0 &&
+                  map(fd, 0, static_cast<uint64_t>(info.st_size), PROT_READ);
+        ::close(fd);
+
+        if (ok)
+            advise(MADV_SEQUENTIAL);
+        return ok;
+#else
+        (void) path;
+        return false;
+#endif
+    }
+
+    /// Map size bytes of a file for writing, starting at offset. The file
+    /// is created if it does not exist, and it is extended if it is shorter
+    /// than offset + size. If truncate is set, the file is also shortened
+    /// to offset + size. Fails if that end position cannot be represented.
+    bool open_write(const char* path, uint64_t offset, uint64_t size,
+                    bool truncate)
+    {
+#if !defined(_WIN32)
+        if (!is_valid_range(offset, size))
+            return false;
+
+        int fd = ::open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        bool ok = ::fstat(fd, &info) == 0;
+
+        uint64_t end = offset + size;
+        if (ok && (truncate || static_cast<uint64_t>(info.st_size) < end))
+            ok = ::ftruncate(fd, static_cast<off_t>(end)) == 0;
+
+        ok = ok && map(fd, offset, size, PROT_READ | PROT_WRITE);
+        ::close(fd);
+
+        if (ok)
+            advise(MADV_SEQUENTIAL);
+        return ok;
+#else
+        (void) path; (void) offset; (void) size; (void) truncate;
+        return false;
+#endif
+    }
+
+    /// Unmap the file. The changes to a writable mapping are written back
+    /// by the kernel.
+    void close()
+    {
+#if !defined(_WIN32)
+        if (m_mapping != nullptr)
+            ::munmap(m_mapping, m_mapping_size);
+#endif
+        m_mapping = nullptr;
+        m_mapping_size = 0;
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    /// Exchange the mappings of two objects
+    void swap(file_mapping& other)
+    {
+        std::swap(m_mapping, other.m_mapping);
+        std::swap(m_mapping_size, other.m_mapping_size);
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+    }
+
+    /// @return The mapped data, or nullptr if nothing is mapped
+    uint8_t* data() const
+    {
+        return m_data;
+    }
+
+    /// @return The size of the mapped data in bytes
+    uint64_t size() const
+    {
+        return m_size;
+    }
+
+private:
+
+#if !defined(_WIN32)
+    /// @return True if offset + size fits in a file position, so the end
+    ///         of the range neither wraps around nor becomes negative
+    static bool is_valid_range(uint64_t offset, uint64_t size)
+    {
+        uint64_t max = static_cast<uint64_t>(
+            std::numeric_limits<off_t>::max());
+
+        return offset <= max && size <= max - offset;
+    }
+
+    bool map(int fd, uint64_t offset, uint64_t size, int protection)
+    {
+        // An empty range needs no mapping
+        if (size == 0)
+        {
+            close();
+            return true;
+        }
+
+        // The mapping must start at a page boundary
+        uint64_t page_size = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+        uint64_t start = offset / page_size * page_size;
+        uint64_t mapping_size = offset - start + size;
+
+        void* mapping = ::mmap(nullptr, mapping_size, protection, MAP_SHARED,
+                               fd, static_cast<off_t>(start));
+
+        if (mapping == MAP_FAILED)
+            return false;
+
+        close();
+        m_mapping = mapping;
+        m_mapping_size = mapping_size;
+        m_data = static_cast<uint8_t*>(mapping) + (offset - start);
+        m_size = size;
+        return true;
+    }
+
+    void advise(int advice)
+    {
+        if (m_mapping != nullptr)
+            ::madvise(m_mapping, m_mapping_size, advice);
+    }
+#endif
+
+private:
+
+    void* m_mapping = nullptr;
+    uint64_t m_mapping_size = 0;
+    uint8_t* m_data = nullptr;
+    uint64_t m_size = 0;
+};
@@ -0,0 +1,58 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+/// The maximum number of bytes used to store a generation id
+const uint32_t max_generation_id_size = 5;
+
+/// Write a generation id as a variable-length integer, where each byte
+/// carries 7 bits of the value and the high bit signals that more bytes
+/// follow. Small generation ids therefore only use a single byte.
+/// @param data The buffer where the generation id should be written
+/// @param generation The generation id
+/// @return The number of bytes written
+inline uint32_t write_generation_id(uint8_t* data, uint32_t generation)
+{
+    uint32_t bytes = 0;
+    while (generation >= 0x80)
+    {
+        data[bytes++] = static_cast<uint8_t>(generation | 0x80);
+        generation >>= 7;
+    }
+    data[bytes++] = static_cast<uint8_t>(generation);
+    return bytes;
+}
+
+/// Read a generation id written by write_generation_id()
+/// @param data The buffer containing the generation id
+/// @param size The size of the buffer in bytes
+/// @param generation The generation id that was read
+/// @return The number of bytes read, or 0 if the encoding is invalid or
+///         does not fit in the buffer
+inline uint32_t read_generation_id(const uint8_t* data, uint32_t size,
+                                   uint32_t* generation)
+{
+    uint32_t value = 0;
+    for (uint32_t bytes = 0; bytes < max_generation_id_size; ++bytes)
+    {
+        if (bytes == size)
+            return 0;
+
+        // The last byte only has room for the upper 4 bits of the value
+        if (bytes == max_generation_id_size - 1 && (data[bytes] & 0x70) != 0)
+            return 0;
+
+        value |= static_cast<uint32_t>(data[bytes] & 0x7F) << (7 * bytes);
+        if ((data[bytes] & 0x80) == 0)
+        {
+            *generation = value;
+            return bytes + 1;
+        }
+    }
+    return 0;
+}
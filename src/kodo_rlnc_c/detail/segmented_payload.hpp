@@ -0,0 +1,45 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+// A segmented payload consists of a header followed by a symbol. The first
+// byte of the header is the payload type. A systematic header continues
+// with the symbol index as a 32-bit little-endian integer, and a coded
+// header continues with the full coefficient vector.
+
+/// Payload type of a systematic symbol
+const uint8_t segmented_systematic = 0;
+
+/// Payload type of a coded symbol
+const uint8_t segmented_coded = 1;
+
+/// @param coefficient_vector_size The size of the coefficient vector
+/// @return The maximum size of a segmented payload header
+inline uint32_t max_segmented_header_size(uint32_t coefficient_vector_size)
+{
+    return 1 + std::max<uint32_t>(sizeof(uint32_t), coefficient_vector_size);
+}
+
+/// Write a 32-bit little-endian integer
+inline void write_uint32(uint8_t* data, uint32_t value)
+{
+    data[0] = static_cast<uint8_t>(value);
+    data[1] = static_cast<uint8_t>(value >> 8);
+    data[2] = static_cast<uint8_t>(value >> 16);
+    data[3] = static_cast<uint8_t>(value >> 24);
+}
+
+/// Read a 32-bit little-endian integer
+inline uint32_t read_uint32(const uint8_t* data)
+{
+    return static_cast<uint32_t>(data[0]) |
+           static_cast<uint32_t>(data[1]) << 8 |
+           static_cast<uint32_t>(data[2]) << 16 |
+           static_cast<uint32_t>(data[3]) << 24;
+}
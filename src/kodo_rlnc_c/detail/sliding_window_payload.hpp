@@ -0,0 +1,29 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include "segmented_payload.hpp"
+
+// A sliding window payload starts with the sequence number of the first
+// symbol in the coding window and the number of symbols in the window,
+// both as 32-bit little-endian integers, see write_uint32(). It continues
+// with one binary8 coefficient for every symbol in the window, followed by
+// the coded symbol. A systematic symbol is sent as a window of one symbol
+// with the coefficient 1.
+
+/// The size of the window bounds at the start of a payload
+const uint32_t sliding_window_bounds_size = 2 * sizeof(uint32_t);
+
+/// @param capacity The maximum number of symbols in the window
+/// @param symbol_size The size of a symbol
+/// @return The maximum size of a sliding window payload
+inline uint32_t sliding_window_max_payload_size(
+    uint32_t capacity, uint32_t symbol_size)
+{
+    return sliding_window_bounds_size + capacity + symbol_size;
+}
@@ -0,0 +1,53 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+/// Remembers the storage of individual symbols, which kodo does not expose.
+/// The table is allocated on first use.
+class symbol_storage_table
+{
+public:
+
+    /// Remember the storage of a symbol
+    /// @param symbols The number of symbols of the coder
+    /// @param data The storage of the symbol
+    /// @param index The index of the symbol
+    void remember(uint32_t symbols, uint8_t* data, uint32_t index)
+    {
+        assert(index < symbols);
+
+        if (m_table.size() < symbols)
+            m_table.resize(symbols, nullptr);
+
+        m_table[index] = data;
+    }
+
+    /// @return The remembered storage of a symbol, or nullptr if it is not
+    ///         known. The table may be smaller than the current number of
+    ///         symbols after the coder was reconfigured.
+    uint8_t* get(uint32_t index) const
+    {
+        if (index >= m_table.size())
+            return nullptr;
+
+        return m_table[index];
+    }
+
+    /// Forget the storage of all symbols, but keep the table
+    void clear()
+    {
+        std::fill(m_table.begin(), m_table.end(), nullptr);
+    }
+
+private:
+
+    std::vector<uint8_t*> m_table;
+};
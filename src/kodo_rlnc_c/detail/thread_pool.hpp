@@ -0,0 +1,199 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+/// A fixed set of worker threads that run a batch of indexed tasks.
+///
+/// The tasks of a batch are split into one contiguous range per worker.
+/// A worker first runs the tasks of its own range and then steals tasks
+/// from the ranges of the other workers, so an uneven batch still keeps
+/// all workers busy. Tasks are claimed with a single atomic increment, the
+/// mutex is only used to start a batch and to signal that it is done.
+class thread_pool
+{
+public:
+
+    /// The task function, which is invoked with the index of the worker
+    /// running it and the index of the task
+    using task_function = std::function<void(uint32_t, uint32_t)>;
+
+    /// @param threads The number of worker threads
+    explicit thread_pool(uint32_t threads) :
+        m_thread_count(threads),
+        m_ranges(new range[threads])
+    {
+        assert(threads > 0);
+
+        for (uint32_t i = 0; i < threads; ++i)
+            m_threads.emplace_back(&thread_pool::run, this, i);
+    }
+
+    ~thread_pool()
+    {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+
+        for (auto& thread : m_threads)
+            thread.join();
+    }
+
+    /// @return The number of worker threads
+    uint32_t threads() const
+    {
+        return m_thread_count;
+    }
+
+    /// Pin a worker thread to a CPU core. Thread affinity is only supported
+    /// on Linux, elsewhere this fails.
+    /// @return True if the worker was pinned
+    bool pin(uint32_t worker, uint32_t cpu)
+    {
+        assert(worker < m_thread_count);
+
+#if defined(__linux__)
+        if (cpu >= CPU_SETSIZE)
+            return false;
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(cpu, &cpus);
+        return pthread_setaffinity_np(m_threads[worker].native_handle(),
+                                      sizeof(cpus), &cpus) == 0;
+#else
+        (void) worker; (void) cpu;
+        return false;
+#endif
+    }
+
+    /// Start running task(worker, index) for every index in [0, count).
+    /// The function returns immediately, use wait() to block until all
+    /// tasks are done. A previous batch is waited for before the new batch
+    /// is started.
+    void dispatch(uint32_t count, task_function task)
+    {
+        wait();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        uint32_t threads = this->threads();
+        for (uint32_t i = 0; i < threads; ++i)
+        {
+            uint64_t begin = static_cast<uint64_t>(count) * i / threads;
+            uint64_t end = static_cast<uint64_t>(count) * (i + 1) / threads;
+            m_ranges[i].m_next.store(static_cast<uint32_t>(begin),
+                                     std::memory_order_relaxed);
+            m_ranges[i].m_end = static_cast<uint32_t>(end);
+        }
+
+        m_task = std::move(task);
+        m_busy = threads;
+        ++m_batch;
+
+        m_wake.notify_all();
+    }
+
+    /// Run a batch of tasks and block until all of them are done
+    void run_and_wait(uint32_t count, task_function task)
+    {
+        dispatch(count, std::move(task));
+        wait();
+    }
+
+    /// Block until the current batch is done
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_busy == 0; });
+    }
+
+private:
+
+    // The tasks owned by a single worker. Padded to a cache line, so the
+    // workers do not contend on each others counters
+    struct range
+    {
+        std::atomic<uint32_t> m_next{0};
+        uint32_t m_end = 0;
+        uint8_t m_padding[56];
+    };
+
+    bool claim(uint32_t owner, uint32_t* task)
+    {
+        range& r = m_ranges[owner];
+        if (r.m_next.load(std::memory_order_relaxed) >= r.m_end)
+            return false;
+
+        *task = r.m_next.fetch_add(1, std::memory_order_relaxed);
+        return *task < r.m_end;
+    }
+
+    void run(uint32_t worker)
+    {
+        uint64_t batch = 0;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_stop || m_batch != batch; });
+
+                if (m_stop)
+                    return;
+
+                batch = m_batch;
+            }
+
+            uint32_t threads = this->threads();
+            uint32_t task = 0;
+
+            // Run the own tasks first and then steal from the others
+            for (uint32_t i = 0; i < threads; ++i)
+            {
+                uint32_t owner = (worker + i) % threads;
+                while (claim(owner, &task))
+                    m_task(worker, task);
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_busy == 0)
+                m_done.notify_all();
+        }
+    }
+
+private:
+
+    const uint32_t m_thread_count;
+    std::vector<std::thread> m_threads;
+    std::unique_ptr<range[]> m_ranges;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    task_function m_task;
+    uint32_t m_busy = 0;
+    uint64_t m_batch = 0;
+    bool m_stop = false;
+};
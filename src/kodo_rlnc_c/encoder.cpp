@@ -5,25 +5,427 @@
 
 #include "encoder.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <cstdint>
 #include <cassert>
+#include <memory>
+#include <random>
 #include <string>
+#include <vector>
 
 #include <kodo_rlnc/coders.hpp>
 
 #include "convert_enums.hpp"
+#include "detail/coder_cache.hpp"
+#include "detail/coefficient_vector.hpp"
+#include "detail/column_slices.hpp"
+#include "detail/elimination.hpp"
+#include "detail/feedback.hpp"
+#include "detail/file_mapping.hpp"
+#include "detail/segmented_payload.hpp"
+#include "detail/symbol_storage_table.hpp"
 
 struct krlnc_encoder
 {
-    template<class... Args>
-    krlnc_encoder(Args&&... args) :
-        m_impl(std::forward<Args>(args)...)
+    krlnc_encoder(fifi::finite_field field, uint32_t symbols,
+                  uint32_t symbol_size) :
+        m_impl(new kodo_rlnc::encoder(field, symbols, symbol_size)),
+        m_field(field),
+        m_default_systematic(m_impl->is_systematic_on()),
+        m_default_density(m_impl->density())
     { }
 
-    kodo_rlnc::encoder m_impl;
+    std::unique_ptr<kodo_rlnc::encoder> m_impl;
+    fifi::finite_field m_field;
+
+    // The configuration of a new encoder, which is restored by
+    // krlnc_encoder_restore_defaults()
+    bool m_default_systematic;
+    float m_default_density;
+
+    // The coders of recently used geometries, if they are kept, and the
+    // coding vector format and seed, which are applied when the encoder is
+    // reconfigured
+    coder_cache<kodo_rlnc::encoder> m_coders;
+    kodo_rlnc::coding_vector_format m_format =
+        kodo_rlnc::coding_vector_format::full_vector;
+    uint32_t m_seed = 0;
+    bool m_has_seed = false;
+
+    // The storage of each symbol, so that systematic payload segments can
+    // point directly to the symbol data
+    symbol_storage_table m_symbol_storage;
+
+    // The header and symbol buffer for payload segments, allocated on
+    // first use
+    std::vector<uint8_t> m_segment_buffer;
+
+    // The arithmetic of the cache-blocked pass over the binary8 symbols
+    elimination m_elimination;
+
+    // The index of the next systematic symbol sent as payload segments, and
+    // whether payload segments were produced since the last reset
+    uint32_t m_systematic_index = 0;
+    bool m_segmented = false;
+
+    // The last feedback from the decoder. It is only used if
+    // m_has_feedback is set.
+    std::vector<uint8_t> m_feedback;
+    bool m_has_feedback = false;
+
+    // The file that is used as symbol storage, if any
+    file_mapping m_file;
+
+    // The coders that split the coded symbols by column ranges. Only
+    // created if the column threads split the symbols into several slices.
+    // The thread pool is kept when the slices are rebuilt for a new
+    // geometry, until the number of threads changes.
+    std::unique_ptr<thread_pool> m_column_pool;
+    std::unique_ptr<column_slices<kodo_rlnc::encoder>> m_columns;
+    uint32_t m_column_threads = 0;
+
+    // Cumulative statistics of all produced payloads
+    krlnc_encoder_stats m_stats = { 0, 0, 0, 0, 0, 0, 0 };
+    bool m_timing = false;
 };
 
+// Create the column slices for the current geometry, and give them the
+// symbol storage that is already set
+static void create_columns(krlnc_encoder_t encoder)
+{
+    kodo_rlnc::encoder& impl = *encoder->m_impl;
+    encoder->m_columns.reset();
+
+    uint32_t slices = column_slices<kodo_rlnc::encoder>::slice_count(
+        impl.symbol_size(), encoder->m_column_threads);
+
+    if (slices < 2)
+        return;
+
+    if (encoder->m_column_pool == nullptr)
+    {
+        encoder->m_column_pool.reset(
+            new thread_pool(encoder->m_column_threads));
+    }
+
+    encoder->m_columns.reset(new column_slices<kodo_rlnc::encoder>(
+        encoder->m_field, impl.symbols(), impl.symbol_size(),
+        *encoder->m_column_pool));
+
+    for (uint32_t i = 0; i < impl.symbols(); ++i)
+    {
+        uint8_t* data = encoder->m_symbol_storage.get(i);
+        if (data != nullptr)
+            encoder->m_columns->set_symbol_storage(data, i);
+    }
+}
+
+// Produce a coded symbol, which is split across the column threads if
+// there are several slices
+static void produce_symbol(
+    krlnc_encoder_t encoder, uint8_t* symbol, uint8_t* coefficients)
+{
+    if (encoder->m_columns == nullptr)
+    {
+        encoder->m_impl->produce_symbol(symbol, coefficients);
+        return;
+    }
+
+    column_slices<kodo_rlnc::encoder>& columns = *encoder->m_columns;
+    columns.run([&](uint32_t slice)
+    {
+        columns.coder(slice).produce_symbol(
+            symbol + columns.offset(slice), coefficients);
+    });
+}
+
+// Call a produce function, which returns the number of bytes produced, and
+// measure the time it takes if timing is on
+template<class Function>
+static uint32_t timed(krlnc_encoder_t encoder, Function&& function)
+{
+    if (!encoder->m_timing)
+        return function();
+
+    krlnc_encoder_stats& stats = encoder->m_stats;
+
+    auto start = std::chrono::steady_clock::now();
+    uint32_t bytes = function();
+    auto stop = std::chrono::steady_clock::now();
+
+    ++stats.timed_calls;
+    stats.time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        stop - start).count();
+
+    return bytes;
+}
+
+// Count a produced payload or symbol in the statistics
+static void count_payload(
+    krlnc_encoder_t encoder, bool systematic, uint32_t bytes)
+{
+    krlnc_encoder_stats& stats = encoder->m_stats;
+
+    ++stats.payloads_produced;
+    if (systematic)
+        ++stats.systematic_payloads;
+    else
+        ++stats.coded_payloads;
+    stats.bytes_produced += bytes;
+}
+
+// Produce a payload or symbol with the given function and update the
+// statistics. The function returns the number of bytes produced, and a
+// failed call that produces nothing is not counted.
+template<class Function>
+static uint32_t produce(
+    krlnc_encoder_t encoder, bool systematic, Function&& function)
+{
+    uint32_t bytes = timed(encoder, function);
+
+    if (bytes != 0)
+        count_payload(encoder, systematic, bytes);
+
+    return bytes;
+}
+
+// Produce a kodo payload, which is systematic in the systematic phase and
+// is otherwise coded with a newly generated coding vector
+static uint32_t produce_payload(krlnc_encoder_t encoder, uint8_t* payload)
+{
+    bool systematic = encoder->m_impl->in_systematic_phase();
+    if (!systematic)
+        ++encoder->m_stats.coefficients_generated;
+
+    return produce(encoder, systematic,
+                   [&] { return encoder->m_impl->produce_payload(payload); });
+}
+
+// Return true if the last feedback has a pivot for the symbol
+static bool is_symbol_received(krlnc_encoder_t encoder, uint32_t index)
+{
+    return encoder->m_has_feedback &&
+           feedback_has_pivot(encoder->m_feedback.data(), index);
+}
+
+// Set the coefficients of the symbols that the decoder has a pivot for to
+// zero, so the coded symbol is innovative for the decoder
+static void exclude_received_symbols(
+    krlnc_encoder_t encoder, uint8_t* coefficients)
+{
+    if (!encoder->m_has_feedback)
+        return;
+
+    uint32_t rank = encoder->m_impl->rank();
+    uint32_t first_missing = rank;
+    bool empty = true;
+
+    for (uint32_t index = 0; index < rank; ++index)
+    {
+        if (is_symbol_received(encoder, index))
+        {
+            set_coefficient_value(encoder->m_field, coefficients, index, 0);
+            continue;
+        }
+
+        first_missing = std::min(first_missing, index);
+        if (coefficient_value(encoder->m_field, coefficients, index) != 0)
+            empty = false;
+    }
+
+    // The remaining coefficients can all be zero, which is likely in small
+    // fields when few symbols are missing
+    if (empty && first_missing < rank)
+        set_coefficient_value(encoder->m_field, coefficients, first_missing, 1);
+}
+
+// Return true if the next payload segments are systematic. The systematic
+// symbols that the decoder already has are skipped first.
+static bool in_segmented_systematic_phase(krlnc_encoder_t encoder)
+{
+    while (encoder->m_systematic_index < encoder->m_impl->rank() &&
+           is_symbol_received(encoder, encoder->m_systematic_index))
+    {
+        ++encoder->m_systematic_index;
+    }
+
+    return encoder->m_impl->is_systematic_on() &&
+           encoder->m_systematic_index < encoder->m_impl->rank();
+}
+
+// Write the header of a coded payload in the segmented format, which is the
+// payload type followed by a newly generated coding vector
+static void write_coded_header(krlnc_encoder_t encoder, uint8_t* header)
+{
+    kodo_rlnc::encoder& impl = *encoder->m_impl;
+    uint8_t* coefficients = header + 1;
+
+    header[0] = segmented_coded;
+
+    if (impl.rank() < impl.symbols())
+        impl.generate_partial(coefficients);
+    else
+        impl.generate(coefficients);
+    ++encoder->m_stats.coefficients_generated;
+
+    exclude_received_symbols(encoder, coefficients);
+}
+
+// Produce a payload in the segmented format, see
+// krlnc_encoder_produce_payload_segments()
+static uint32_t produce_payload_segments(
+    krlnc_encoder_t encoder, krlnc_payload_segments* segments,
+    bool systematic)
+{
+    kodo_rlnc::encoder& impl = *encoder->m_impl;
+    uint32_t header_capacity =
+        max_segmented_header_size(impl.coefficient_vector_size());
+
+    encoder->m_segment_buffer.resize(header_capacity + impl.symbol_size());
+
+    uint8_t* header = encoder->m_segment_buffer.data();
+    uint8_t* symbol = header + header_capacity;
+
+    segments->header = header;
+    segments->symbol_size = impl.symbol_size();
+
+    uint32_t index = encoder->m_systematic_index;
+    if (systematic)
+    {
+        header[0] = segmented_systematic;
+        write_uint32(header + 1, index);
+        segments->header_size = 1 + sizeof(uint32_t);
+
+        uint8_t* data = encoder->m_symbol_storage.get(index);
+        if (data != nullptr)
+        {
+            segments->symbol = data;
+        }
+        else
+        {
+            impl.produce_systematic_symbol(symbol, index);
+            segments->symbol = symbol;
+        }
+
+        ++encoder->m_systematic_index;
+    }
+    else
+    {
+        write_coded_header(encoder, header);
+        produce_symbol(encoder, symbol, header + 1);
+
+        segments->header_size = 1 + impl.coefficient_vector_size();
+        segments->symbol = symbol;
+    }
+
+    return segments->header_size + segments->symbol_size;
+}
+
+// Return true if the coded payloads can be produced in one cache-blocked
+// pass. The pass combines the symbols with the binary8 arithmetic on the
+// calling thread, so it needs the storage of every symbol and is not used
+// when the symbols are split across the column threads.
+static bool can_produce_blocked(krlnc_encoder_t encoder)
+{
+    if (encoder->m_field != fifi::finite_field::binary8 ||
+        encoder->m_columns != nullptr)
+    {
+        return false;
+    }
+
+    for (uint32_t index = 0; index < encoder->m_impl->rank(); ++index)
+    {
+        if (encoder->m_symbol_storage.get(index) == nullptr)
+            return false;
+    }
+    return true;
+}
+
+// Return the number of bytes of each symbol that the cache-blocked pass
+// combines at a time. The blocks of all outputs and of one source symbol
+// should fit in a 256 KB L2 cache, but the blocks are kept long enough for
+// the vector instructions.
+static uint32_t column_block_size(uint32_t symbol_size, uint32_t outputs)
+{
+    uint32_t block = (256 * 1024) / (outputs + 1);
+    block = std::max<uint32_t>(block - block % 64, 1024);
+    return std::min(block, symbol_size);
+}
+
+// Produce the symbols of several coded payloads whose headers are already
+// written. Every column block of a source symbol is read once and added to
+// the same block of all outputs, so the source block is read from memory
+// once for the whole batch instead of once per payload.
+static void produce_symbols_blocked(
+    krlnc_encoder_t encoder, uint8_t* payloads, uint32_t count,
+    uint32_t stride)
+{
+    kodo_rlnc::encoder& impl = *encoder->m_impl;
+    uint32_t header_size = 1 + impl.coefficient_vector_size();
+    uint32_t symbol_size = impl.symbol_size();
+    uint32_t block = column_block_size(symbol_size, count);
+
+    uint8_t* payload = payloads;
+    for (uint32_t i = 0; i < count; ++i, payload += stride)
+        std::memset(payload + header_size, 0, symbol_size);
+
+    for (uint32_t offset = 0; offset < symbol_size; offset += block)
+    {
+        uint32_t size = std::min(block, symbol_size - offset);
+
+        for (uint32_t index = 0; index < impl.rank(); ++index)
+        {
+            const uint8_t* source =
+                encoder->m_symbol_storage.get(index) + offset;
+
+            payload = payloads;
+            for (uint32_t i = 0; i < count; ++i, payload += stride)
+            {
+                // A binary8 coefficient is a single byte
+                encoder->m_elimination.multiply_add(
+                    payload + header_size + offset, source,
+                    payload[1 + index], size);
+            }
+        }
+    }
+}
+
+// Produce several coded payloads in the segmented format, written
+// back-to-back with the given stride. See
+// krlnc_encoder_produce_segmented_payloads().
+static uint32_t produce_coded_payloads(
+    krlnc_encoder_t encoder, uint8_t* payloads, uint32_t count,
+    uint32_t stride, uint32_t* sizes)
+{
+    kodo_rlnc::encoder& impl = *encoder->m_impl;
+    uint32_t bytes = 1 + impl.coefficient_vector_size() + impl.symbol_size();
+    bool blocked = can_produce_blocked(encoder);
+
+    uint8_t* payload = payloads;
+    for (uint32_t i = 0; i < count; ++i, payload += stride)
+    {
+        write_coded_header(encoder, payload);
+
+        if (!blocked)
+        {
+            produce_symbol(encoder,
+                           payload + 1 + impl.coefficient_vector_size(),
+                           payload + 1);
+        }
+
+        count_payload(encoder, false, bytes);
+        if (sizes != nullptr)
+            sizes[i] = bytes;
+    }
+
+    if (blocked)
+        produce_symbols_blocked(encoder, payloads, count, stride);
+
+    return count * bytes;
+}
+
 //------------------------------------------------------------------
 // ENCODER BASIC API
 //------------------------------------------------------------------
@@ -44,14 +446,108 @@ void krlnc_delete_encoder(krlnc_encoder_t encoder)
 void krlnc_reset_encoder(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    encoder->m_impl.reset();
+    encoder->m_impl->reset();
+    if (encoder->m_columns != nullptr)
+        encoder->m_columns->reset();
+
+    encoder->m_systematic_index = 0;
+    encoder->m_segmented = false;
+    encoder->m_has_feedback = false;
+}
+
+void krlnc_encoder_restore_defaults(krlnc_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+
+    krlnc_encoder_set_column_threads(encoder, 0);
+    krlnc_reset_encoder(encoder);
+
+    kodo_rlnc::encoder& impl = *encoder->m_impl;
+    krlnc_encoder_set_coding_vector_format(encoder, krlnc_full_vector);
+    impl.set_density(encoder->m_default_density);
+
+    if (encoder->m_default_systematic)
+        impl.set_systematic_on();
+    else
+        impl.set_systematic_off();
+
+    // The generator is reseeded, so that the coefficients do not follow a
+    // seed chosen by a previous user
+    if (encoder->m_has_seed)
+    {
+        impl.set_seed(std::random_device()());
+        encoder->m_has_seed = false;
+    }
+
+    impl.set_log_off();
+    impl.set_zone_prefix(std::string());
+
+    encoder->m_coders.set_max_coders(0);
+    encoder->m_symbol_storage.clear();
+    encoder->m_file.close();
+
+    encoder->m_stats = krlnc_encoder_stats();
+    encoder->m_timing = false;
 }
 
 void krlnc_encoder_set_coding_vector_format(
     krlnc_encoder_t encoder, int32_t format_id)
 {
     auto format = c_format_to_krlnc_format(format_id);
-    encoder->m_impl.set_coding_vector_format(format);
+    encoder->m_impl->set_coding_vector_format(format);
+    encoder->m_format = format;
+}
+
+void krlnc_encoder_reconfigure(
+    krlnc_encoder_t encoder, uint32_t symbols, uint32_t symbol_size)
+{
+    assert(encoder != nullptr);
+    assert(symbols > 0);
+    assert(symbol_size > 0);
+
+    kodo_rlnc::encoder& current = *encoder->m_impl;
+
+    if (current.symbols() != symbols || current.symbol_size() != symbol_size)
+    {
+        bool systematic = current.is_systematic_on();
+        float density = current.density();
+
+        encoder->m_coders.select(
+            encoder->m_impl, encoder->m_field, symbols, symbol_size);
+
+        kodo_rlnc::encoder& impl = *encoder->m_impl;
+        impl.set_coding_vector_format(encoder->m_format);
+        impl.set_density(density);
+
+        if (systematic)
+            impl.set_systematic_on();
+        else
+            impl.set_systematic_off();
+    }
+
+    if (encoder->m_has_seed)
+        encoder->m_impl->set_seed(encoder->m_seed);
+
+    krlnc_reset_encoder(encoder);
+
+    // The storage of the previous geometry must be specified again
+    encoder->m_symbol_storage.clear();
+
+    if (encoder->m_column_threads > 1)
+        create_columns(encoder);
+}
+
+void krlnc_encoder_set_reconfigure_cache(
+    krlnc_encoder_t encoder, uint32_t coders)
+{
+    assert(encoder != nullptr);
+    encoder->m_coders.set_max_coders(coders);
+}
+
+uint32_t krlnc_encoder_reconfigure_cache(krlnc_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return encoder->m_coders.max_coders();
 }
 
 //------------------------------------------------------------------
@@ -61,33 +557,65 @@ void krlnc_encoder_set_coding_vector_format(
 uint64_t krlnc_encoder_block_size(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    return encoder->m_impl.block_size();
+    return encoder->m_impl->block_size();
 }
 
 uint32_t krlnc_encoder_symbol_size(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    return encoder->m_impl.symbol_size();
+    return encoder->m_impl->symbol_size();
 }
 
 uint32_t krlnc_encoder_symbols(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    return encoder->m_impl.symbols();
+    return encoder->m_impl->symbols();
 }
 
 void krlnc_encoder_set_symbol_storage(
     krlnc_encoder_t encoder, uint8_t* data, uint32_t index)
 {
     assert(encoder != nullptr);
-    encoder->m_impl.set_symbol_storage(data, index);
+    encoder->m_impl->set_symbol_storage(data, index);
+    encoder->m_symbol_storage.remember(
+        encoder->m_impl->symbols(), data, index);
+
+    if (encoder->m_columns != nullptr)
+        encoder->m_columns->set_symbol_storage(data, index);
 }
 
 void krlnc_encoder_set_symbols_storage(
     krlnc_encoder_t encoder, uint8_t* data)
 {
     assert(encoder != nullptr);
-    encoder->m_impl.set_symbols_storage(data);
+    encoder->m_impl->set_symbols_storage(data);
+
+    uint32_t symbols = encoder->m_impl->symbols();
+    uint32_t symbol_size = encoder->m_impl->symbol_size();
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        encoder->m_symbol_storage.remember(
+            symbols, data + i * symbol_size, i);
+
+        if (encoder->m_columns != nullptr)
+            encoder->m_columns->set_symbol_storage(data + i * symbol_size, i);
+    }
+}
+
+uint8_t krlnc_encoder_set_file_storage(
+    krlnc_encoder_t encoder, const char* path, uint64_t offset)
+{
+    assert(encoder != nullptr);
+    assert(path != nullptr);
+
+    if (!encoder->m_file.open_read(
+            path, offset, encoder->m_impl->block_size()))
+    {
+        return 0;
+    }
+
+    krlnc_encoder_set_symbols_storage(encoder, encoder->m_file.data());
+    return 1;
 }
 
 //------------------------------------------------------------------
@@ -97,14 +625,112 @@ void krlnc_encoder_set_symbols_storage(
 uint32_t krlnc_encoder_max_payload_size(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    return encoder->m_impl.max_payload_size();
+    return encoder->m_impl->max_payload_size();
 }
 
 uint32_t krlnc_encoder_produce_payload(
     krlnc_encoder_t encoder, uint8_t* payload)
 {
     assert(encoder != nullptr);
-    return encoder->m_impl.produce_payload(payload);
+    return produce_payload(encoder, payload);
+}
+
+uint32_t krlnc_encoder_produce_payloads(
+    krlnc_encoder_t encoder, uint8_t* payloads, uint32_t count,
+    uint32_t stride, uint32_t* sizes)
+{
+    assert(encoder != nullptr);
+    assert(payloads != nullptr);
+    assert(stride >= encoder->m_impl->max_payload_size());
+
+    uint32_t total_bytes = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        uint32_t bytes = produce_payload(encoder, payloads);
+        if (sizes != nullptr)
+        {
+            sizes[i] = bytes;
+        }
+        total_bytes += bytes;
+        payloads += stride;
+    }
+    return total_bytes;
+}
+
+uint32_t krlnc_encoder_max_segmented_payload_size(krlnc_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return max_segmented_header_size(
+        encoder->m_impl->coefficient_vector_size()) +
+        encoder->m_impl->symbol_size();
+}
+
+uint32_t krlnc_encoder_produce_payload_segments(
+    krlnc_encoder_t encoder, krlnc_payload_segments* segments)
+{
+    assert(encoder != nullptr);
+    assert(segments != nullptr);
+
+    // The seed formats cannot be represented in a segmented header
+    if (encoder->m_format != kodo_rlnc::coding_vector_format::full_vector)
+        return 0;
+
+    encoder->m_segmented = true;
+    bool systematic = in_segmented_systematic_phase(encoder);
+
+    return produce(encoder, systematic, [&]
+    {
+        return produce_payload_segments(encoder, segments, systematic);
+    });
+}
+
+uint32_t krlnc_encoder_produce_segmented_payloads(
+    krlnc_encoder_t encoder, uint8_t* payloads, uint32_t count,
+    uint32_t stride, uint32_t* sizes)
+{
+    assert(encoder != nullptr);
+    assert(payloads != nullptr);
+    assert(stride >= krlnc_encoder_max_segmented_payload_size(encoder));
+
+    // The seed formats cannot be represented in a segmented header
+    if (encoder->m_format != kodo_rlnc::coding_vector_format::full_vector)
+        return 0;
+
+    encoder->m_segmented = true;
+
+    return timed(encoder, [&]
+    {
+        uint32_t total_bytes = 0;
+        uint32_t i = 0;
+
+        // The systematic symbols are copied one at a time
+        for (; i < count && in_segmented_systematic_phase(encoder); ++i)
+        {
+            krlnc_payload_segments segments;
+            uint32_t bytes =
+                produce_payload_segments(encoder, &segments, true);
+
+            std::memcpy(payloads, segments.header, segments.header_size);
+            std::memcpy(payloads + segments.header_size, segments.symbol,
+                        segments.symbol_size);
+            count_payload(encoder, true, bytes);
+
+            if (sizes != nullptr)
+                sizes[i] = bytes;
+
+            total_bytes += bytes;
+            payloads += stride;
+        }
+
+        if (i < count)
+        {
+            total_bytes += produce_coded_payloads(
+                encoder, payloads, count - i, stride,
+                sizes != nullptr ? sizes + i : nullptr);
+        }
+
+        return total_bytes;
+    });
 }
 
 //------------------------------------------------------------------
@@ -114,31 +740,35 @@ uint32_t krlnc_encoder_produce_payload(
 uint32_t krlnc_encoder_rank(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    return encoder->m_impl.rank();
+    return encoder->m_impl->rank();
 }
 
 uint8_t krlnc_encoder_is_systematic_on(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    return encoder->m_impl.is_systematic_on();
+    return encoder->m_impl->is_systematic_on();
 }
 
 void krlnc_encoder_set_systematic_on(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    encoder->m_impl.set_systematic_on();
+    encoder->m_impl->set_systematic_on();
 }
 
 void krlnc_encoder_set_systematic_off(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    encoder->m_impl.set_systematic_off();
+    encoder->m_impl->set_systematic_off();
 }
 
 uint8_t krlnc_encoder_in_systematic_phase(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    return encoder->m_impl.in_systematic_phase();
+
+    if (encoder->m_segmented)
+        return in_segmented_systematic_phase(encoder);
+
+    return encoder->m_impl->in_systematic_phase();
 }
 
 //------------------------------------------------------------------
@@ -148,21 +778,109 @@ uint8_t krlnc_encoder_in_systematic_phase(krlnc_encoder_t encoder)
 uint32_t krlnc_encoder_coefficient_vector_size(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    return encoder->m_impl.coefficient_vector_size();
+    return encoder->m_impl->coefficient_vector_size();
 }
 
 uint32_t krlnc_encoder_produce_symbol(
     krlnc_encoder_t encoder, uint8_t* symbol_data, uint8_t* coefficients)
 {
     assert(encoder != nullptr);
-    return encoder->m_impl.produce_symbol(symbol_data, coefficients);
+    return produce(encoder, false, [&]
+    {
+        produce_symbol(encoder, symbol_data, coefficients);
+        return encoder->m_impl->symbol_size();
+    });
 }
 
 uint32_t krlnc_encoder_produce_systematic_symbol(
     krlnc_encoder_t encoder, uint8_t* symbol_data, uint32_t index)
 {
     assert(encoder != nullptr);
-    return encoder->m_impl.produce_systematic_symbol(symbol_data, index);
+    return produce(encoder, true, [&]
+    {
+        return encoder->m_impl->produce_systematic_symbol(symbol_data, index);
+    });
+}
+
+//------------------------------------------------------------------
+// COLUMN THREADS API
+//------------------------------------------------------------------
+
+void krlnc_encoder_set_column_threads(
+    krlnc_encoder_t encoder, uint32_t threads)
+{
+    assert(encoder != nullptr);
+
+    if (threads == encoder->m_column_threads)
+        return;
+
+    encoder->m_column_threads = threads;
+    encoder->m_columns.reset();
+    encoder->m_column_pool.reset();
+    create_columns(encoder);
+}
+
+uint32_t krlnc_encoder_column_threads(krlnc_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+
+    if (encoder->m_columns == nullptr)
+        return 1;
+
+    return encoder->m_columns->slices();
+}
+
+//------------------------------------------------------------------
+// FEEDBACK API
+//------------------------------------------------------------------
+
+uint32_t krlnc_encoder_feedback_size(krlnc_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return feedback_size(encoder->m_impl->symbols());
+}
+
+void krlnc_encoder_consume_feedback(
+    krlnc_encoder_t encoder, const uint8_t* feedback)
+{
+    assert(encoder != nullptr);
+    assert(feedback != nullptr);
+
+    uint32_t size = feedback_size(encoder->m_impl->symbols());
+    encoder->m_feedback.assign(feedback, feedback + size);
+
+    // Feedback from a decoder without any pivots changes nothing
+    encoder->m_has_feedback = read_uint32(feedback) > 0;
+}
+
+//------------------------------------------------------------------
+// STATISTICS API
+//------------------------------------------------------------------
+
+void krlnc_encoder_get_stats(
+    krlnc_encoder_t encoder, krlnc_encoder_stats* stats)
+{
+    assert(encoder != nullptr);
+    assert(stats != nullptr);
+    *stats = encoder->m_stats;
+}
+
+void krlnc_encoder_reset_stats(krlnc_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    encoder->m_stats = krlnc_encoder_stats();
+}
+
+void krlnc_encoder_set_timing_on(krlnc_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    encoder->m_timing = true;
+}
+
+void krlnc_encoder_set_timing_off(krlnc_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    encoder->m_timing = false;
 }
 
 //------------------------------------------------------------------
@@ -172,32 +890,36 @@ uint32_t krlnc_encoder_produce_systematic_symbol(
 void krlnc_encoder_set_seed(krlnc_encoder_t encoder, uint32_t seed_value)
 {
     assert(encoder != nullptr);
-    encoder->m_impl.set_seed(seed_value);
+    encoder->m_impl->set_seed(seed_value);
+    encoder->m_seed = seed_value;
+    encoder->m_has_seed = true;
 }
 
 void krlnc_encoder_generate(krlnc_encoder_t encoder, uint8_t* coefficients)
 {
     assert(encoder != nullptr);
-    encoder->m_impl.generate(coefficients);
+    encoder->m_impl->generate(coefficients);
+    ++encoder->m_stats.coefficients_generated;
 }
 
 void krlnc_encoder_generate_partial(
     krlnc_encoder_t encoder, uint8_t* coefficients)
 {
     assert(encoder != nullptr);
-    encoder->m_impl.generate_partial(coefficients);
+    encoder->m_impl->generate_partial(coefficients);
+    ++encoder->m_stats.coefficients_generated;
 }
 
 float krlnc_encoder_density(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    return encoder->m_impl.density();
+    return encoder->m_impl->density();
 }
 
 void krlnc_encoder_set_density(krlnc_encoder_t encoder, float density)
 {
     assert(encoder != nullptr);
-    encoder->m_impl.set_density(density);
+    encoder->m_impl->set_density(density);
 }
 
 //------------------------------------------------------------------
@@ -207,7 +929,7 @@ void krlnc_encoder_set_density(krlnc_encoder_t encoder, float density)
 void krlnc_encoder_set_log_stdout(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    encoder->m_impl.set_log_stdout();
+    encoder->m_impl->set_log_stdout();
 }
 
 void krlnc_encoder_set_log_callback(
@@ -221,17 +943,17 @@ void krlnc_encoder_set_log_callback(
     {
         c_callback(zone.c_str(), data.c_str(), context);
     };
-    encoder->m_impl.set_log_callback(callback);
+    encoder->m_impl->set_log_callback(callback);
 }
 
 void krlnc_encoder_set_log_off(krlnc_encoder_t encoder)
 {
     assert(encoder != nullptr);
-    encoder->m_impl.set_log_off();
+    encoder->m_impl->set_log_off();
 }
 
 void krlnc_encoder_set_zone_prefix(krlnc_encoder_t encoder, const char* prefix)
 {
     assert(encoder != nullptr);
-    encoder->m_impl.set_zone_prefix(std::string(prefix));
+    encoder->m_impl->set_zone_prefix(std::string(prefix));
 }
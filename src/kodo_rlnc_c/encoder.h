@@ -20,6 +20,27 @@ extern "C" {
 /// Opaque pointer used for encoder
 typedef struct krlnc_encoder* krlnc_encoder_t;
 
+/// Cumulative statistics of an encoder, see krlnc_encoder_get_stats()
+typedef struct
+{
+    /// The number of payloads and symbols produced
+    uint64_t payloads_produced;
+    /// The number of systematic payloads and symbols produced
+    uint64_t systematic_payloads;
+    /// The number of coded payloads and symbols produced
+    uint64_t coded_payloads;
+    /// The number of bytes written to payloads and symbols
+    uint64_t bytes_produced;
+    /// The number of coding vectors generated, both for coded payloads and
+    /// by the coefficient generator API
+    uint64_t coefficients_generated;
+    /// The number of produce calls that were timed
+    uint64_t timed_calls;
+    /// The total time spent in the timed produce calls in nanoseconds
+    uint64_t time_ns;
+}
+krlnc_encoder_stats;
+
 //------------------------------------------------------------------
 // ENCODER BASIC API
 //------------------------------------------------------------------
@@ -43,6 +64,19 @@ void krlnc_delete_encoder(krlnc_encoder_t encoder);
 KODO_RLNC_API
 void krlnc_reset_encoder(krlnc_encoder_t encoder);
 
+/// Reset the encoder and restore the configuration of a new encoder, while
+/// the finite field and the geometry are kept. This switches the column
+/// threads and the timing off, restores the coding vector format, the
+/// density and the systematic mode, turns the log off, drops the
+/// reconfigure cache, forgets the symbol storage, unmaps the file storage
+/// and clears the statistics. If a seed was set, the coefficient generator
+/// is reseeded with a random seed. Coder pools call this when an encoder is
+/// released, so the next user does not inherit the settings of the
+/// previous one.
+/// @param encoder The encoder to restore
+KODO_RLNC_API
+void krlnc_encoder_restore_defaults(krlnc_encoder_t encoder);
+
 /// Set the coding vector format
 /// @param encoder The encoder which should be configured
 /// @param format_id The selected coding vector format
@@ -50,6 +84,41 @@ KODO_RLNC_API
 void krlnc_encoder_set_coding_vector_format(
     krlnc_encoder_t encoder, int32_t format_id);
 
+/// Change the number of symbols and the symbol size of the encoder, and reset
+/// it. This is cheaper than creating a new encoder, e.g. for the shorter last
+/// generation of a message. The buffers of the encoder are reused if they are
+/// large enough. The internal coder of the previous geometry is released,
+/// unless krlnc_encoder_set_reconfigure_cache() keeps it for later. The coding
+/// vector format, the systematic mode and the density are kept, while the log
+/// settings only apply to the geometry they were set for. If a seed was set
+/// with krlnc_encoder_set_seed(), the coefficient generator restarts from that
+/// seed, also when the geometry is unchanged. The symbol storage must be
+/// specified again.
+/// @param encoder The encoder which should be reconfigured
+/// @param symbols The new number of symbols
+/// @param symbol_size The new size of a symbol in bytes
+KODO_RLNC_API
+void krlnc_encoder_reconfigure(
+    krlnc_encoder_t encoder, uint32_t symbols, uint32_t symbol_size);
+
+/// Set the number of internal coders of earlier geometries that are kept by
+/// krlnc_encoder_reconfigure(), so switching back to one of these geometries
+/// does not allocate. Every coder holds the state of a full generation, so
+/// the least recently used coder is released when there are more. The
+/// default is 0, which releases the coder of the previous geometry.
+/// @param encoder The encoder to configure
+/// @param coders The maximum number of coders that are kept
+KODO_RLNC_API
+void krlnc_encoder_set_reconfigure_cache(
+    krlnc_encoder_t encoder, uint32_t coders);
+
+/// Return the number of internal coders of earlier geometries that are
+/// kept by krlnc_encoder_reconfigure().
+/// @param encoder The encoder to query
+/// @return The maximum number of coders that are kept
+KODO_RLNC_API
+uint32_t krlnc_encoder_reconfigure_cache(krlnc_encoder_t encoder);
+
 //------------------------------------------------------------------
 // SYMBOL STORAGE API
 //------------------------------------------------------------------
@@ -89,6 +158,22 @@ KODO_RLNC_API
 void krlnc_encoder_set_symbols_storage(
     krlnc_encoder_t encoder, uint8_t* data);
 
+/// Specify a file that contains the symbols to be encoded. The block_size
+/// bytes starting at offset are mapped into memory and used as the symbol
+/// storage, so the data is encoded directly from the page cache without
+/// being copied. The file stays mapped until the encoder is deleted or
+/// another file is specified. Memory mapped files are only supported on
+/// POSIX systems.
+/// @param encoder The encoder which will encode the data
+/// @param path The path of the file
+/// @param offset The position of the first symbol in the file
+/// @return Non-zero if the file was mapped, 0 if it could not be opened,
+///         is too short or cannot be mapped. If the file is not mapped, the
+///         symbol storage is unchanged.
+KODO_RLNC_API
+uint8_t krlnc_encoder_set_file_storage(
+    krlnc_encoder_t encoder, const char* path, uint64_t offset);
+
 //------------------------------------------------------------------
 // PAYLOAD API
 //------------------------------------------------------------------
@@ -109,6 +194,88 @@ KODO_RLNC_API
 uint32_t krlnc_encoder_produce_payload(
     krlnc_encoder_t encoder, uint8_t* payload);
 
+/// Produce several payloads in a single call. The payloads are written
+/// back-to-back into one buffer, where each payload starts at a multiple of
+/// the stride. This is equivalent to calling krlnc_encoder_produce_payload()
+/// count times, but avoids the per-payload call overhead. The kodo payload
+/// format is produced by the codec, so every coded payload is still a
+/// separate pass over the symbols. A burst of coded payloads is produced in
+/// a single pass with krlnc_encoder_produce_segmented_payloads().
+/// @param encoder The encoder to use.
+/// @param payloads The buffer which should contain the payloads. It must
+///        have a capacity of at least count * stride bytes.
+/// @param count The number of payloads to produce
+/// @param stride The distance in bytes between the start of two consecutive
+///        payloads. It must be at least krlnc_encoder_max_payload_size().
+/// @param sizes If not NULL, the size of each payload is written to this
+///        array, which must have room for count elements.
+/// @return The total bytes used by all the produced payloads
+KODO_RLNC_API
+uint32_t krlnc_encoder_produce_payloads(
+    krlnc_encoder_t encoder, uint8_t* payloads, uint32_t count,
+    uint32_t stride, uint32_t* sizes);
+
+/// Return the maximum size of a segmented payload, i.e. the size of the
+/// largest header plus the symbol size.
+/// @param encoder The encoder to query.
+/// @return The segmented payload size in bytes
+KODO_RLNC_API
+uint32_t krlnc_encoder_max_segmented_payload_size(krlnc_encoder_t encoder);
+
+/// Produce a payload as a header segment and a symbol segment, which can be
+/// passed to sendmsg() or similar functions without copying the symbol.
+/// For a systematic symbol, the symbol segment points directly into the
+/// symbol storage. For a coded symbol, both segments point to buffers
+/// inside the encoder. The segments stay valid until the next call to this
+/// function.
+/// Segmented payloads use their own format, which is consumed with
+/// krlnc_decoder_consume_segmented_payload() and not with
+/// krlnc_decoder_consume_payload(). A coded segmented payload always
+/// carries the full coefficient vector, so this function only works with
+/// the krlnc_full_vector coding vector format.
+/// An encoder should either use this function or
+/// krlnc_encoder_produce_payload() after it is reset, since they keep
+/// separate track of the systematic symbols that were sent. Once this
+/// function has been called, krlnc_encoder_in_systematic_phase() reports
+/// the systematic phase of the segmented payloads.
+/// @param encoder The encoder to use.
+/// @param segments The segments describing the produced payload.
+/// @return The total size of the payload in bytes, or 0 if the coding
+///         vector format is not krlnc_full_vector
+KODO_RLNC_API
+uint32_t krlnc_encoder_produce_payload_segments(
+    krlnc_encoder_t encoder, krlnc_payload_segments* segments);
+
+/// Produce several payloads in the segmented format in a single call. The
+/// payloads are written back-to-back into one buffer, where each payload
+/// starts at a multiple of the stride and holds its header followed by its
+/// symbol. The payloads are the same as those of count calls to
+/// krlnc_encoder_produce_payload_segments(), and they are consumed with
+/// krlnc_decoder_consume_segmented_payload().
+/// The systematic payloads are copied from the symbol storage one at a
+/// time. With the binary8 field, the coded payloads are produced in one
+/// cache-blocked pass: a column block of each symbol is read once and added
+/// to all the payloads, so the symbols are read once per call instead of
+/// once per payload. The pass runs on the calling thread and needs the
+/// storage of every symbol, so other fields, symbols split across column
+/// threads and symbols whose storage was not specified fall back to one
+/// pass per payload. If timing is on, the whole call is timed once.
+/// @param encoder The encoder to use.
+/// @param payloads The buffer which should contain the payloads. It must
+///        have a capacity of at least count * stride bytes.
+/// @param count The number of payloads to produce
+/// @param stride The distance in bytes between the start of two consecutive
+///        payloads. It must be at least
+///        krlnc_encoder_max_segmented_payload_size().
+/// @param sizes If not NULL, the size of each payload is written to this
+///        array, which must have room for count elements.
+/// @return The total bytes used by all the produced payloads, or 0 if the
+///         coding vector format is not krlnc_full_vector
+KODO_RLNC_API
+uint32_t krlnc_encoder_produce_segmented_payloads(
+    krlnc_encoder_t encoder, uint8_t* payloads, uint32_t count,
+    uint32_t stride, uint32_t* sizes);
+
 //------------------------------------------------------------------
 // ENCODER API
 //------------------------------------------------------------------
@@ -138,7 +305,9 @@ KODO_RLNC_API
 void krlnc_encoder_set_systematic_off(krlnc_encoder_t encoder);
 
 /// Return whether the encoder is in the systematic phase, i.e. there
-/// is a systematic packet to send
+/// is a systematic packet to send. This follows the payloads of
+/// krlnc_encoder_produce_payload_segments() if that function was used
+/// since the encoder was reset, and otherwise krlnc_encoder_produce_payload().
 /// @param encoder The encoder
 /// @return Non-zero if the encoder is in the systematic phase, otherwise 0
 KODO_RLNC_API
@@ -174,6 +343,94 @@ KODO_RLNC_API
 uint32_t krlnc_encoder_produce_systematic_symbol(
     krlnc_encoder_t encoder, uint8_t* symbol_data, uint32_t index);
 
+//------------------------------------------------------------------
+// COLUMN THREADS API
+//------------------------------------------------------------------
+
+/// Split every coded symbol into column ranges that are produced
+/// concurrently on a pool of threads. This lowers the latency of a single
+/// payload when the symbols are large, e.g. hundreds of kilobytes. The
+/// splitting applies to krlnc_encoder_produce_symbol() and to the coded
+/// payloads of krlnc_encoder_produce_payload_segments(), while
+/// krlnc_encoder_produce_payload() still runs on the calling thread. Every
+/// thread gets at least 16 KB of a symbol, so fewer threads are used for
+/// smaller symbols. The setting and the threads are kept when the encoder
+/// is reset or reconfigured.
+/// @param encoder The encoder to use
+/// @param threads The number of threads, 0 or 1 turns the splitting off
+KODO_RLNC_API
+void krlnc_encoder_set_column_threads(
+    krlnc_encoder_t encoder, uint32_t threads);
+
+/// Return the number of column ranges that a coded symbol is split into.
+/// @param encoder The encoder to query
+/// @return The number of column ranges, which is 1 if the symbols are not
+///         split
+KODO_RLNC_API
+uint32_t krlnc_encoder_column_threads(krlnc_encoder_t encoder);
+
+//------------------------------------------------------------------
+// FEEDBACK API
+//------------------------------------------------------------------
+
+/// Return the size of a feedback message.
+/// @param encoder The encoder to query
+/// @return The feedback size in bytes
+KODO_RLNC_API
+uint32_t krlnc_encoder_feedback_size(krlnc_encoder_t encoder);
+
+/// Consume a feedback message that was produced with
+/// krlnc_decoder_produce_feedback(). The feedback replaces any earlier
+/// feedback, and it is cleared when the encoder is reset.
+///
+/// Feedback only has an effect on the segmented wire format. To use it,
+/// both sides must switch to krlnc_encoder_produce_payload_segments() and
+/// krlnc_decoder_consume_segmented_payload(). The payloads produced with
+/// krlnc_encoder_produce_payload() ignore the feedback, since their coding
+/// vectors are generated by the codec, so they keep repairing blindly.
+///
+/// With the segmented format, the encoder skips the systematic symbols that
+/// the decoder has a pivot for, and the coded payloads only combine the
+/// symbols that the decoder has no pivot for. Such a payload is innovative
+/// for the decoder unless it has received more payloads since the feedback
+/// was sent.
+/// @param encoder The encoder to use
+/// @param feedback The buffer storing the feedback
+KODO_RLNC_API
+void krlnc_encoder_consume_feedback(
+    krlnc_encoder_t encoder, const uint8_t* feedback);
+
+//------------------------------------------------------------------
+// STATISTICS API
+//------------------------------------------------------------------
+
+/// Return the cumulative statistics of an encoder. The counters are updated
+/// by every function that produces a payload or a symbol, and they are not
+/// cleared when the encoder is reset.
+/// @param encoder The encoder to query
+/// @param stats The statistics to fill
+KODO_RLNC_API
+void krlnc_encoder_get_stats(
+    krlnc_encoder_t encoder, krlnc_encoder_stats* stats);
+
+/// Clear the statistics of an encoder.
+/// @param encoder The encoder to use
+KODO_RLNC_API
+void krlnc_encoder_reset_stats(krlnc_encoder_t encoder);
+
+/// Switch the timing of produce calls on. The time spent producing each
+/// payload or symbol is measured with a monotonic clock and accumulated in
+/// the statistics. Timing is off by default, since reading the clock adds
+/// a small cost to every call.
+/// @param encoder The encoder to use
+KODO_RLNC_API
+void krlnc_encoder_set_timing_on(krlnc_encoder_t encoder);
+
+/// Switch the timing of produce calls off.
+/// @param encoder The encoder to use
+KODO_RLNC_API
+void krlnc_encoder_set_timing_off(krlnc_encoder_t encoder);
+
 //------------------------------------------------------------------
 // COEFFICIENT GENERATOR API
 //------------------------------------------------------------------
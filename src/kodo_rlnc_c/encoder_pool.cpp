@@ -0,0 +1,83 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include "encoder_pool.h"
+
+#include <cstdint>
+#include <cassert>
+
+#include "detail/coder_pool.hpp"
+
+// The functions that the pool uses to manage its encoders
+struct encoder_functions
+{
+    static krlnc_encoder_t create(
+        int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size)
+    {
+        return krlnc_create_encoder(finite_field_id, symbols, symbol_size);
+    }
+
+    static void destroy(krlnc_encoder_t encoder)
+    {
+        krlnc_delete_encoder(encoder);
+    }
+
+    static void restore_defaults(krlnc_encoder_t encoder)
+    {
+        krlnc_encoder_restore_defaults(encoder);
+    }
+
+    static uint32_t symbols(krlnc_encoder_t encoder)
+    {
+        return krlnc_encoder_symbols(encoder);
+    }
+
+    static uint32_t symbol_size(krlnc_encoder_t encoder)
+    {
+        return krlnc_encoder_symbol_size(encoder);
+    }
+};
+
+struct krlnc_encoder_pool : coder_pool<krlnc_encoder_t, encoder_functions>
+{
+    using coder_pool::coder_pool;
+};
+
+//------------------------------------------------------------------
+// ENCODER POOL API
+//------------------------------------------------------------------
+
+krlnc_encoder_pool_t krlnc_create_encoder_pool(
+    int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size,
+    uint32_t encoders)
+{
+    return new krlnc_encoder_pool(
+        finite_field_id, symbols, symbol_size, encoders);
+}
+
+void krlnc_delete_encoder_pool(krlnc_encoder_pool_t pool)
+{
+    assert(pool != nullptr);
+    delete pool;
+}
+
+krlnc_encoder_t krlnc_encoder_pool_acquire(krlnc_encoder_pool_t pool)
+{
+    assert(pool != nullptr);
+    return pool->acquire();
+}
+
+void krlnc_encoder_pool_release(
+    krlnc_encoder_pool_t pool, krlnc_encoder_t encoder)
+{
+    assert(pool != nullptr);
+    pool->release(encoder);
+}
+
+uint32_t krlnc_encoder_pool_available(krlnc_encoder_pool_t pool)
+{
+    assert(pool != nullptr);
+    return pool->available();
+}
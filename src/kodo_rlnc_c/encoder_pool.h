@@ -0,0 +1,78 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+#include "encoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------
+// KODO-RLNC-C TYPES
+//------------------------------------------------------------------
+
+/// Opaque pointer used for encoder pool
+typedef struct krlnc_encoder_pool* krlnc_encoder_pool_t;
+
+//------------------------------------------------------------------
+// ENCODER POOL API
+//------------------------------------------------------------------
+
+/// Create a new encoder pool. The pool hands out encoders that share the same
+/// finite field, number of symbols and symbol size. Released encoders are
+/// reset and kept for later use, so acquiring and releasing an encoder does not
+/// allocate memory once the pool is warm. A pool is not thread-safe, so
+/// each thread should use its own pool.
+/// @param finite_field_id The finite field that should be used.
+/// @param symbols The number of symbols in a coding block
+/// @param symbol_size The size of a symbol in bytes
+/// @param encoders The number of encoders that are created up front
+/// @return Pointer to a new encoder pool instance.
+KODO_RLNC_API
+krlnc_encoder_pool_t krlnc_create_encoder_pool(
+    int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size,
+    uint32_t encoders);
+
+/// Deallocate and release the memory consumed by an encoder pool, including
+/// all the encoders kept in the pool. All acquired encoders must be released
+/// before the pool is deleted.
+/// @param pool The encoder pool which should be deallocated
+KODO_RLNC_API
+void krlnc_delete_encoder_pool(krlnc_encoder_pool_t pool);
+
+/// Acquire an encoder from the pool. A new encoder is created if the pool is
+/// empty.
+/// @param pool The encoder pool to use
+/// @return An encoder in a clean state
+KODO_RLNC_API
+krlnc_encoder_t krlnc_encoder_pool_acquire(krlnc_encoder_pool_t pool);
+
+/// Release an encoder back to the pool. The encoder is reset and gets the
+/// configuration of a new encoder back, see
+/// krlnc_encoder_restore_defaults(), so the next user does not inherit
+/// callbacks, seeds or other settings. An encoder that was reconfigured to
+/// another geometry is deleted instead of being kept.
+/// @param pool The encoder pool to use
+/// @param encoder The encoder to release, which must have been acquired from
+///        this pool
+KODO_RLNC_API
+void krlnc_encoder_pool_release(
+    krlnc_encoder_pool_t pool, krlnc_encoder_t encoder);
+
+/// Return the number of encoders that are ready to be acquired without
+/// allocating memory.
+/// @param pool The encoder pool to query
+/// @return The number of encoders in the pool
+KODO_RLNC_API
+uint32_t krlnc_encoder_pool_available(krlnc_encoder_pool_t pool);
+
+#ifdef __cplusplus
+}
+#endif
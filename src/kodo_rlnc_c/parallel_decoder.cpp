@@ -0,0 +1,448 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include "parallel_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+#include "detail/elimination.hpp"
+#include "detail/segmented_payload.hpp"
+#include "detail/thread_pool.hpp"
+
+// The number of bytes that a task should at least multiply and add, so the
+// work outweighs the cost of waking up a worker
+static const uint64_t min_task_size = 64 * 1024;
+
+// The column ranges of the forward elimination are split at the cache line
+// boundaries of the new row, so the workers do not write to the same cache
+// lines
+static const uint32_t column_alignment = 64;
+
+struct krlnc_parallel_decoder
+{
+    krlnc_parallel_decoder(uint32_t symbols, uint32_t symbol_size,
+                           uint32_t threads) :
+        m_symbols(symbols),
+        m_symbol_size(symbol_size),
+        m_pool(threads),
+        m_coefficients(uint64_t{symbols} * symbols),
+        m_pivot(symbols, 0),
+        m_vector(symbols),
+        m_symbol(symbol_size)
+    {
+        m_rows.reserve(symbols);
+    }
+
+    uint32_t m_symbols;
+    uint32_t m_symbol_size;
+
+    thread_pool m_pool;
+    elimination m_field;
+
+    // The decoding matrix in reduced echelon form. The row of a pivot is
+    // stored at the index of the pivot, and its symbol is stored at the
+    // same index in the symbol storage.
+    std::vector<uint8_t> m_coefficients;
+    std::vector<uint8_t> m_pivot;
+    uint32_t m_rank = 0;
+    uint8_t* m_storage = nullptr;
+
+    // The rows that a new symbol is combined with, and their multipliers
+    struct row
+    {
+        uint32_t m_index;
+        uint8_t m_multiplier;
+    };
+    std::vector<row> m_rows;
+
+    // Used to consume systematic symbols
+    std::vector<uint8_t> m_vector;
+    std::vector<uint8_t> m_symbol;
+};
+
+static uint8_t* row_coefficients(
+    krlnc_parallel_decoder_t decoder, uint32_t index)
+{
+    return decoder->m_coefficients.data() +
+           uint64_t{index} * decoder->m_symbols;
+}
+
+static uint8_t* row_symbol(krlnc_parallel_decoder_t decoder, uint32_t index)
+{
+    return decoder->m_storage + uint64_t{index} * decoder->m_symbol_size;
+}
+
+// Return the offset in a buffer where the range of a task starts. The
+// buffer is split evenly, and the offset is moved back to the start of a
+// cache line, so two tasks never write to the same cache line.
+static uint64_t range_offset(const uint8_t* data, uint64_t size,
+                             uint32_t task, uint32_t tasks)
+{
+    if (task == 0)
+        return 0;
+    if (task >= tasks)
+        return size;
+
+    uint64_t offset = size * task / tasks;
+    uint64_t misalignment =
+        (reinterpret_cast<uintptr_t>(data) + offset) % column_alignment;
+
+    return offset - std::min(offset, misalignment);
+}
+
+// Split work of the given size into tasks, and run them on the workers. A
+// single task runs on the calling thread.
+template<class Function>
+static void run_tasks(krlnc_parallel_decoder_t decoder, uint64_t work,
+                      uint32_t max_tasks, Function&& function)
+{
+    uint64_t tasks = std::min<uint64_t>(
+        std::min(decoder->m_pool.threads(), max_tasks),
+        work / min_task_size);
+
+    if (tasks < 2)
+    {
+        function(0, 1);
+        return;
+    }
+
+    decoder->m_pool.run_and_wait(static_cast<uint32_t>(tasks),
+        [&](uint32_t, uint32_t task)
+        {
+            function(task, static_cast<uint32_t>(tasks));
+        });
+}
+
+// Subtract the rows in m_rows from a new row. The matrix is fully reduced,
+// so every row is subtracted independently of the others. The coefficients
+// and the symbol are stored apart, so each of them is split into column
+// ranges of its own, and every task takes one range of both.
+static void eliminate_forward(krlnc_parallel_decoder_t decoder,
+                              uint8_t* coefficients, uint8_t* symbol)
+{
+    const elimination& field = decoder->m_field;
+    uint32_t symbols = decoder->m_symbols;
+    uint32_t symbol_size = decoder->m_symbol_size;
+    uint64_t work = (uint64_t{symbols} + symbol_size) * decoder->m_rows.size();
+
+    uint32_t max_tasks = std::max<uint32_t>(1, symbol_size / column_alignment);
+
+    run_tasks(decoder, work, max_tasks, [&](uint32_t task, uint32_t tasks)
+    {
+        uint64_t coefficients_begin =
+            range_offset(coefficients, symbols, task, tasks);
+        uint64_t coefficients_end =
+            range_offset(coefficients, symbols, task + 1, tasks);
+        uint64_t symbol_begin =
+            range_offset(symbol, symbol_size, task, tasks);
+        uint64_t symbol_end =
+            range_offset(symbol, symbol_size, task + 1, tasks);
+
+        for (const auto& row : decoder->m_rows)
+        {
+            field.multiply_add(
+                coefficients + coefficients_begin,
+                row_coefficients(decoder, row.m_index) + coefficients_begin,
+                row.m_multiplier,
+                static_cast<uint32_t>(coefficients_end - coefficients_begin));
+            field.multiply_add(
+                symbol + symbol_begin,
+                row_symbol(decoder, row.m_index) + symbol_begin,
+                row.m_multiplier,
+                static_cast<uint32_t>(symbol_end - symbol_begin));
+        }
+    });
+}
+
+// Subtract a multiple of a new row from the rows in m_rows, so the pivot
+// column of the new row is zero in all other rows. The rows are split into
+// blocks.
+static void substitute_backward(krlnc_parallel_decoder_t decoder,
+                                const uint8_t* coefficients,
+                                const uint8_t* symbol)
+{
+    const elimination& field = decoder->m_field;
+    uint32_t count = static_cast<uint32_t>(decoder->m_rows.size());
+    uint64_t width = uint64_t{decoder->m_symbols} + decoder->m_symbol_size;
+
+    run_tasks(decoder, width * count, count, [&](uint32_t task,
+                                                  uint32_t tasks)
+    {
+        uint32_t begin = static_cast<uint32_t>(uint64_t{count} * task / tasks);
+        uint32_t end = static_cast<uint32_t>(
+            uint64_t{count} * (task + 1) / tasks);
+
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            const auto& row = decoder->m_rows[i];
+            field.subtract_row(row_coefficients(decoder, row.m_index),
+                               row_symbol(decoder, row.m_index),
+                               coefficients, symbol, row.m_multiplier,
+                               decoder->m_symbols, decoder->m_symbol_size);
+        }
+    });
+}
+
+// Add a symbol to the decoding matrix, if it is linearly independent of the
+// existing rows
+static void consume(krlnc_parallel_decoder_t decoder, uint8_t* coefficients,
+                    uint8_t* symbol)
+{
+    assert(decoder->m_storage != nullptr);
+
+    uint32_t symbols = decoder->m_symbols;
+    auto& rows = decoder->m_rows;
+
+    // The pivot columns of a reduced row are zero in all other rows, so
+    // the multipliers are the coefficients of the new symbol at the pivots
+    rows.clear();
+    for (uint32_t index = 0; index < symbols; ++index)
+    {
+        if (decoder->m_pivot[index] && coefficients[index] != 0)
+            rows.push_back({ index, coefficients[index] });
+    }
+
+    eliminate_forward(decoder, coefficients, symbol);
+
+    uint32_t pivot = elimination::find_pivot(coefficients, 0, symbols);
+
+    // The symbol was linearly dependent
+    if (pivot == symbols)
+        return;
+
+    decoder->m_field.normalize_row(coefficients, symbol, pivot, symbols,
+                                   decoder->m_symbol_size);
+
+    rows.clear();
+    for (uint32_t index = 0; index < symbols; ++index)
+    {
+        uint8_t value = row_coefficients(decoder, index)[pivot];
+        if (decoder->m_pivot[index] && value != 0)
+            rows.push_back({ index, value });
+    }
+
+    substitute_backward(decoder, coefficients, symbol);
+
+    std::memcpy(row_coefficients(decoder, pivot), coefficients, symbols);
+    std::memcpy(row_symbol(decoder, pivot), symbol, decoder->m_symbol_size);
+    decoder->m_pivot[pivot] = 1;
+    ++decoder->m_rank;
+}
+
+//------------------------------------------------------------------
+// PARALLEL DECODER BASIC API
+//------------------------------------------------------------------
+
+krlnc_parallel_decoder_t krlnc_create_parallel_decoder(
+    uint32_t symbols, uint32_t symbol_size, uint32_t threads)
+{
+    assert(symbols > 0);
+    assert(symbol_size > 0);
+
+    if (threads == 0)
+        threads = std::max(1U, std::thread::hardware_concurrency());
+
+    return new krlnc_parallel_decoder(symbols, symbol_size, threads);
+}
+
+void krlnc_delete_parallel_decoder(krlnc_parallel_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    delete decoder;
+}
+
+void krlnc_reset_parallel_decoder(krlnc_parallel_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    std::fill(decoder->m_pivot.begin(), decoder->m_pivot.end(), 0);
+    decoder->m_rank = 0;
+}
+
+uint32_t krlnc_parallel_decoder_symbols(krlnc_parallel_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_symbols;
+}
+
+uint32_t krlnc_parallel_decoder_symbol_size(
+    krlnc_parallel_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_symbol_size;
+}
+
+uint64_t krlnc_parallel_decoder_block_size(krlnc_parallel_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return uint64_t{decoder->m_symbols} * decoder->m_symbol_size;
+}
+
+uint32_t krlnc_parallel_decoder_threads(krlnc_parallel_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_pool.threads();
+}
+
+uint8_t krlnc_parallel_decoder_set_thread_affinity(
+    krlnc_parallel_decoder_t decoder, const uint32_t* cpus, uint32_t count)
+{
+    assert(decoder != nullptr);
+    assert(cpus != nullptr);
+    assert(count > 0);
+
+    bool pinned = true;
+    for (uint32_t worker = 0; worker < decoder->m_pool.threads(); ++worker)
+    {
+        if (!decoder->m_pool.pin(worker, cpus[worker % count]))
+            pinned = false;
+    }
+    return pinned;
+}
+
+//------------------------------------------------------------------
+// SYMBOL STORAGE API
+//------------------------------------------------------------------
+
+void krlnc_parallel_decoder_set_symbols_storage(
+    krlnc_parallel_decoder_t decoder, uint8_t* data)
+{
+    assert(decoder != nullptr);
+    assert(data != nullptr);
+    decoder->m_storage = data;
+}
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+uint32_t krlnc_parallel_decoder_max_segmented_payload_size(
+    krlnc_parallel_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return max_segmented_header_size(decoder->m_symbols) +
+           decoder->m_symbol_size;
+}
+
+void krlnc_parallel_decoder_consume_segmented_payload(
+    krlnc_parallel_decoder_t decoder, uint8_t* payload,
+    uint32_t payload_size)
+{
+    assert(decoder != nullptr);
+    assert(payload != nullptr);
+
+    if (payload_size == 0)
+        return;
+
+    if (payload[0] == segmented_systematic)
+    {
+        uint32_t header_size = 1 + sizeof(uint32_t);
+        if (payload_size < header_size + decoder->m_symbol_size)
+            return;
+
+        uint32_t index = read_uint32(payload + 1);
+        if (index >= decoder->m_symbols)
+            return;
+
+        krlnc_parallel_decoder_consume_systematic_symbol(
+            decoder, payload + header_size, index);
+    }
+    else if (payload[0] == segmented_coded)
+    {
+        uint32_t header_size = 1 + decoder->m_symbols;
+        if (payload_size < header_size + decoder->m_symbol_size)
+            return;
+
+        consume(decoder, payload + 1, payload + header_size);
+    }
+}
+
+//------------------------------------------------------------------
+// DECODER API
+//------------------------------------------------------------------
+
+uint8_t krlnc_parallel_decoder_is_complete(krlnc_parallel_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_rank == decoder->m_symbols;
+}
+
+uint32_t krlnc_parallel_decoder_rank(krlnc_parallel_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_rank;
+}
+
+uint8_t krlnc_parallel_decoder_is_symbol_pivot(
+    krlnc_parallel_decoder_t decoder, uint32_t index)
+{
+    assert(decoder != nullptr);
+    assert(index < decoder->m_symbols);
+    return decoder->m_pivot[index];
+}
+
+uint8_t krlnc_parallel_decoder_is_symbol_decoded(
+    krlnc_parallel_decoder_t decoder, uint32_t index)
+{
+    assert(decoder != nullptr);
+    assert(index < decoder->m_symbols);
+
+    if (!decoder->m_pivot[index])
+        return 0;
+
+    // A row is decoded when its pivot is its only non-zero coefficient
+    const uint8_t* coefficients = row_coefficients(decoder, index);
+    for (uint32_t column = 0; column < decoder->m_symbols; ++column)
+    {
+        if (column != index && coefficients[column] != 0)
+            return 0;
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------
+// SYMBOL API
+//------------------------------------------------------------------
+
+uint32_t krlnc_parallel_decoder_coefficient_vector_size(
+    krlnc_parallel_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_symbols;
+}
+
+void krlnc_parallel_decoder_consume_symbol(
+    krlnc_parallel_decoder_t decoder, uint8_t* symbol_data,
+    uint8_t* coefficients)
+{
+    assert(decoder != nullptr);
+    assert(symbol_data != nullptr);
+    assert(coefficients != nullptr);
+
+    consume(decoder, coefficients, symbol_data);
+}
+
+void krlnc_parallel_decoder_consume_systematic_symbol(
+    krlnc_parallel_decoder_t decoder, const uint8_t* symbol_data,
+    uint32_t index)
+{
+    assert(decoder != nullptr);
+    assert(symbol_data != nullptr);
+    assert(index < decoder->m_symbols);
+
+    if (krlnc_parallel_decoder_is_symbol_decoded(decoder, index))
+        return;
+
+    std::fill(decoder->m_vector.begin(), decoder->m_vector.end(), 0);
+    decoder->m_vector[index] = 1;
+    std::memcpy(decoder->m_symbol.data(), symbol_data,
+                decoder->m_symbol_size);
+
+    consume(decoder, decoder->m_vector.data(), decoder->m_symbol.data());
+}
@@ -0,0 +1,205 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------
+// KODO-RLNC-C TYPES
+//------------------------------------------------------------------
+
+/// Opaque pointer used for parallel decoder
+typedef struct krlnc_parallel_decoder* krlnc_parallel_decoder_t;
+
+//------------------------------------------------------------------
+// PARALLEL DECODER BASIC API
+//------------------------------------------------------------------
+
+/// Create a new parallel decoder object. A parallel decoder decodes a
+/// single generation on a pool of worker threads, which is useful for
+/// large generations of e.g. a thousand symbols or more, where every
+/// consumed symbol touches many rows of the decoding matrix.
+///
+/// The decoding matrix is kept in reduced echelon form. The forward
+/// elimination of a new symbol is split across the workers by column
+/// ranges, and the backward substitution into the existing rows is split by
+/// row blocks. Small operations are done on the calling thread, so the
+/// workers are only woken up when there is enough work to share.
+///
+/// The parallel decoder only supports the krlnc_binary8 field. It consumes
+/// the payloads of krlnc_encoder_produce_payload_segments() with the full
+/// vector coding vector format, or symbols with their coefficients. The
+/// payloads of krlnc_encoder_produce_payload() cannot be consumed, since
+/// their format is internal to kodo.
+/// @param symbols The number of symbols in a generation
+/// @param symbol_size The size of a symbol in bytes
+/// @param threads The number of worker threads. If 0, one thread is used
+///        for each hardware thread.
+/// @return Pointer to a new parallel decoder instance.
+KODO_RLNC_API
+krlnc_parallel_decoder_t krlnc_create_parallel_decoder(
+    uint32_t symbols, uint32_t symbol_size, uint32_t threads);
+
+/// Deallocate and release the memory consumed by a parallel decoder. This
+/// stops the worker threads.
+/// @param decoder The parallel decoder which should be deallocated
+KODO_RLNC_API
+void krlnc_delete_parallel_decoder(krlnc_parallel_decoder_t decoder);
+
+/// Reset the state of the parallel decoder, so a new generation can be
+/// decoded. The symbol storage and the thread affinity are kept.
+/// @param decoder The parallel decoder which should be reset
+KODO_RLNC_API
+void krlnc_reset_parallel_decoder(krlnc_parallel_decoder_t decoder);
+
+/// Return the number of symbols in a generation.
+/// @param decoder The parallel decoder to query
+/// @return The number of symbols
+KODO_RLNC_API
+uint32_t krlnc_parallel_decoder_symbols(krlnc_parallel_decoder_t decoder);
+
+/// Return the symbol size in bytes.
+/// @param decoder The parallel decoder to query
+/// @return The size of a symbol in bytes
+KODO_RLNC_API
+uint32_t krlnc_parallel_decoder_symbol_size(
+    krlnc_parallel_decoder_t decoder);
+
+/// Return the block size, i.e. the number of symbols times the symbol size.
+/// @param decoder The parallel decoder to query
+/// @return The block size in bytes
+KODO_RLNC_API
+uint64_t krlnc_parallel_decoder_block_size(krlnc_parallel_decoder_t decoder);
+
+/// Return the number of worker threads.
+/// @param decoder The parallel decoder to query
+/// @return The number of worker threads
+KODO_RLNC_API
+uint32_t krlnc_parallel_decoder_threads(krlnc_parallel_decoder_t decoder);
+
+/// Pin the worker threads to CPU cores, so the decoding matrix stays in the
+/// caches of the chosen cores. Worker i is pinned to cpus[i % count].
+/// Thread affinity is only supported on Linux.
+/// @param decoder The parallel decoder to use
+/// @param cpus The indices of the CPU cores
+/// @param count The number of CPU cores
+/// @return Non-zero if all the workers were pinned
+KODO_RLNC_API
+uint8_t krlnc_parallel_decoder_set_thread_affinity(
+    krlnc_parallel_decoder_t decoder, const uint32_t* cpus, uint32_t count);
+
+//------------------------------------------------------------------
+// SYMBOL STORAGE API
+//------------------------------------------------------------------
+
+/// Specify the symbol storage of the parallel decoder. The decoded symbols
+/// are written to this buffer, and the buffer is used for the partially
+/// decoded symbols until the generation is complete. The storage must be
+/// set before any symbols are consumed.
+/// @param decoder The parallel decoder which will decode the data
+/// @param data The buffer of krlnc_parallel_decoder_block_size() bytes
+KODO_RLNC_API
+void krlnc_parallel_decoder_set_symbols_storage(
+    krlnc_parallel_decoder_t decoder, uint8_t* data);
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+/// Return the maximum size of a segmented payload.
+/// @param decoder The parallel decoder to query
+/// @return The maximum size of a segmented payload in bytes
+KODO_RLNC_API
+uint32_t krlnc_parallel_decoder_max_segmented_payload_size(
+    krlnc_parallel_decoder_t decoder);
+
+/// Consume a payload that was produced with
+/// krlnc_encoder_produce_payload_segments(), with the header and the symbol
+/// stored after each other in one buffer. Payloads that are too short are
+/// ignored.
+/// @param decoder The parallel decoder to use
+/// @param payload The payload, which may be changed by this operation
+/// @param payload_size The size of the payload in bytes
+KODO_RLNC_API
+void krlnc_parallel_decoder_consume_segmented_payload(
+    krlnc_parallel_decoder_t decoder, uint8_t* payload,
+    uint32_t payload_size);
+
+//------------------------------------------------------------------
+// DECODER API
+//------------------------------------------------------------------
+
+/// Check whether decoding is complete.
+/// @param decoder The parallel decoder to query
+/// @return Non-zero if the decoding is complete, otherwise 0
+KODO_RLNC_API
+uint8_t krlnc_parallel_decoder_is_complete(krlnc_parallel_decoder_t decoder);
+
+/// Return the rank of the parallel decoder, which is the number of
+/// linearly independent symbols it has received.
+/// @param decoder The parallel decoder to query
+/// @return The rank of the decoder
+KODO_RLNC_API
+uint32_t krlnc_parallel_decoder_rank(krlnc_parallel_decoder_t decoder);
+
+/// Check whether a symbol is a pivot, i.e. whether a row of the decoding
+/// matrix starts at the symbol.
+/// @param decoder The parallel decoder to query
+/// @param index Index of the symbol whose state should be checked
+/// @return Non-zero if the symbol is a pivot, otherwise 0
+KODO_RLNC_API
+uint8_t krlnc_parallel_decoder_is_symbol_pivot(
+    krlnc_parallel_decoder_t decoder, uint32_t index);
+
+/// Check whether a symbol is decoded, in which case its data is in the
+/// symbol storage.
+/// @param decoder The parallel decoder to query
+/// @param index Index of the symbol whose state should be checked
+/// @return Non-zero if the symbol is decoded, otherwise 0
+KODO_RLNC_API
+uint8_t krlnc_parallel_decoder_is_symbol_decoded(
+    krlnc_parallel_decoder_t decoder, uint32_t index);
+
+//------------------------------------------------------------------
+// SYMBOL API
+//------------------------------------------------------------------
+
+/// Return the size of a coefficient vector, which is one byte per symbol.
+/// @param decoder The parallel decoder to query
+/// @return The size of a coefficient vector in bytes
+KODO_RLNC_API
+uint32_t krlnc_parallel_decoder_coefficient_vector_size(
+    krlnc_parallel_decoder_t decoder);
+
+/// Consume a coded symbol.
+/// @param decoder The parallel decoder to use
+/// @param symbol_data The coded symbol, which may be changed by this
+///        operation
+/// @param coefficients The coding coefficients of the symbol, which may be
+///        changed by this operation
+KODO_RLNC_API
+void krlnc_parallel_decoder_consume_symbol(
+    krlnc_parallel_decoder_t decoder, uint8_t* symbol_data,
+    uint8_t* coefficients);
+
+/// Consume a systematic symbol.
+/// @param decoder The parallel decoder to use
+/// @param symbol_data The systematic symbol
+/// @param index The index of the symbol in the generation
+KODO_RLNC_API
+void krlnc_parallel_decoder_consume_systematic_symbol(
+    krlnc_parallel_decoder_t decoder, const uint8_t* symbol_data,
+    uint32_t index);
+
+#ifdef __cplusplus
+}
+#endif
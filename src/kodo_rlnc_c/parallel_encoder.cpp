@@ -0,0 +1,252 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include "parallel_encoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cassert>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "block_encoder.h"
+#include "detail/thread_pool.hpp"
+
+struct krlnc_parallel_encoder
+{
+    krlnc_parallel_encoder(int32_t finite_field_id, uint32_t symbols,
+                           uint32_t symbol_size, uint32_t threads) :
+        m_pool(threads)
+    {
+        for (uint32_t i = 0; i < threads; ++i)
+        {
+            m_encoders.push_back(krlnc_create_block_encoder(
+                finite_field_id, symbols, symbol_size));
+        }
+        m_stride = krlnc_block_encoder_max_payload_size(m_encoders[0]);
+    }
+
+    ~krlnc_parallel_encoder()
+    {
+        m_pool.wait();
+
+        for (auto encoder : m_encoders)
+            krlnc_delete_block_encoder(encoder);
+    }
+
+    thread_pool m_pool;
+
+    // One block encoder for each worker thread
+    std::vector<krlnc_block_encoder_t> m_encoders;
+
+    uint32_t m_stride = 0;
+    uint32_t m_generations = 0;
+
+    // The range of generations that is currently being encoded
+    uint32_t m_first = 0;
+    uint32_t m_count = 0;
+    uint32_t m_payloads = 0;
+
+    // The payloads and payload sizes of every generation in the range
+    std::vector<uint8_t> m_payload_buffer;
+    std::vector<uint32_t> m_payload_sizes;
+
+    // Completion queue: the workers reserve a position with m_tail, write
+    // the completed task to m_order and then publish it with m_ready.
+    // The caller is the only reader, so m_head needs no synchronization.
+    std::vector<uint32_t> m_order;
+    std::unique_ptr<std::atomic<uint8_t>[]> m_ready;
+    uint32_t m_ready_capacity = 0;
+    std::atomic<uint32_t> m_tail{0};
+    uint32_t m_head = 0;
+};
+
+static void encode_generation(
+    krlnc_parallel_encoder_t encoder, uint32_t worker, uint32_t task)
+{
+    krlnc_block_encoder_t block_encoder = encoder->m_encoders[worker];
+    krlnc_block_encoder_set_generation(block_encoder, encoder->m_first + task);
+
+    uint64_t first_payload = static_cast<uint64_t>(task) * encoder->m_payloads;
+    uint8_t* payload = encoder->m_payload_buffer.data() +
+                       first_payload * encoder->m_stride;
+    uint32_t* sizes = encoder->m_payload_sizes.data() + first_payload;
+
+    for (uint32_t i = 0; i < encoder->m_payloads; ++i)
+    {
+        sizes[i] = krlnc_block_encoder_produce_payload(block_encoder, payload);
+        payload += encoder->m_stride;
+    }
+
+    uint32_t position = encoder->m_tail.fetch_add(1, std::memory_order_relaxed);
+    encoder->m_order[position] = task;
+    encoder->m_ready[position].store(1, std::memory_order_release);
+}
+
+//------------------------------------------------------------------
+// PARALLEL ENCODER BASIC API
+//------------------------------------------------------------------
+
+krlnc_parallel_encoder_t krlnc_create_parallel_encoder(
+    int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size,
+    uint32_t threads)
+{
+    if (threads == 0)
+        threads = std::max(1U, std::thread::hardware_concurrency());
+
+    return new krlnc_parallel_encoder(
+        finite_field_id, symbols, symbol_size, threads);
+}
+
+void krlnc_delete_parallel_encoder(krlnc_parallel_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    delete encoder;
+}
+
+uint32_t krlnc_parallel_encoder_threads(krlnc_parallel_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return encoder->m_pool.threads();
+}
+
+void krlnc_parallel_encoder_set_coding_vector_format(
+    krlnc_parallel_encoder_t encoder, int32_t format_id)
+{
+    assert(encoder != nullptr);
+
+    for (auto block_encoder : encoder->m_encoders)
+        krlnc_block_encoder_set_coding_vector_format(block_encoder, format_id);
+}
+
+void krlnc_parallel_encoder_set_systematic_on(
+    krlnc_parallel_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+
+    for (auto block_encoder : encoder->m_encoders)
+        krlnc_block_encoder_set_systematic_on(block_encoder);
+}
+
+void krlnc_parallel_encoder_set_systematic_off(
+    krlnc_parallel_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+
+    for (auto block_encoder : encoder->m_encoders)
+        krlnc_block_encoder_set_systematic_off(block_encoder);
+}
+
+//------------------------------------------------------------------
+// DATA API
+//------------------------------------------------------------------
+
+uint8_t krlnc_parallel_encoder_set_data(
+    krlnc_parallel_encoder_t encoder, uint8_t* data, uint64_t size)
+{
+    assert(encoder != nullptr);
+
+    // All block encoders have the same geometry, so they either all accept
+    // the data or all reject it
+    for (auto block_encoder : encoder->m_encoders)
+    {
+        if (!krlnc_block_encoder_set_data(block_encoder, data, size))
+            return 0;
+    }
+
+    encoder->m_generations =
+        krlnc_block_encoder_generations(encoder->m_encoders[0]);
+    return 1;
+}
+
+uint32_t krlnc_parallel_encoder_generations(krlnc_parallel_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return encoder->m_generations;
+}
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+uint32_t krlnc_parallel_encoder_max_payload_size(
+    krlnc_parallel_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return encoder->m_stride;
+}
+
+void krlnc_parallel_encoder_start(
+    krlnc_parallel_encoder_t encoder, uint32_t first_generation,
+    uint32_t generations, uint32_t payloads)
+{
+    assert(encoder != nullptr);
+    assert(first_generation + generations <= encoder->m_generations);
+
+    encoder->m_pool.wait();
+
+    encoder->m_first = first_generation;
+    encoder->m_count = generations;
+    encoder->m_payloads = payloads;
+
+    uint64_t total_payloads = static_cast<uint64_t>(generations) * payloads;
+    encoder->m_payload_buffer.resize(total_payloads * encoder->m_stride);
+    encoder->m_payload_sizes.resize(total_payloads);
+
+    if (encoder->m_ready_capacity < generations)
+    {
+        encoder->m_ready.reset(new std::atomic<uint8_t>[generations]);
+        encoder->m_ready_capacity = generations;
+    }
+    for (uint32_t i = 0; i < generations; ++i)
+        encoder->m_ready[i].store(0, std::memory_order_relaxed);
+
+    encoder->m_order.resize(generations);
+    encoder->m_tail.store(0, std::memory_order_relaxed);
+    encoder->m_head = 0;
+
+    encoder->m_pool.dispatch(generations,
+        [encoder](uint32_t worker, uint32_t task)
+        {
+            encode_generation(encoder, worker, task);
+        });
+}
+
+uint8_t krlnc_parallel_encoder_collect(
+    krlnc_parallel_encoder_t encoder, uint32_t* generation,
+    const uint8_t** payloads, const uint32_t** sizes)
+{
+    assert(encoder != nullptr);
+    assert(generation != nullptr);
+    assert(payloads != nullptr);
+    assert(sizes != nullptr);
+
+    uint32_t head = encoder->m_head;
+
+    if (head == encoder->m_count ||
+        !encoder->m_ready[head].load(std::memory_order_acquire))
+    {
+        return 0;
+    }
+
+    uint32_t task = encoder->m_order[head];
+    uint64_t first_payload = static_cast<uint64_t>(task) * encoder->m_payloads;
+
+    *generation = encoder->m_first + task;
+    *payloads = encoder->m_payload_buffer.data() +
+                first_payload * encoder->m_stride;
+    *sizes = encoder->m_payload_sizes.data() + first_payload;
+
+    encoder->m_head = head + 1;
+    return 1;
+}
+
+void krlnc_parallel_encoder_wait(krlnc_parallel_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    encoder->m_pool.wait();
+}
@@ -0,0 +1,151 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------
+// KODO-RLNC-C TYPES
+//------------------------------------------------------------------
+
+/// Opaque pointer used for parallel encoder
+typedef struct krlnc_parallel_encoder* krlnc_parallel_encoder_t;
+
+//------------------------------------------------------------------
+// PARALLEL ENCODER BASIC API
+//------------------------------------------------------------------
+
+/// Create a new parallel encoder object. A parallel encoder splits data
+/// into generations in the same way as a block encoder, and encodes
+/// several generations concurrently on a pool of worker threads. Every
+/// worker has its own encoder. The produced payloads can be consumed by a
+/// block decoder.
+/// @param finite_field_id The finite field that should be used.
+/// @param symbols The number of symbols in a generation
+/// @param symbol_size The size of a symbol in bytes
+/// @param threads The number of worker threads. If 0, one thread is used
+///        for each hardware thread.
+/// @return Pointer to a new parallel encoder instance.
+KODO_RLNC_API
+krlnc_parallel_encoder_t krlnc_create_parallel_encoder(
+    int32_t finite_field_id, uint32_t symbols, uint32_t symbol_size,
+    uint32_t threads);
+
+/// Deallocate and release the memory consumed by a parallel encoder. This
+/// waits for the running generations to finish and stops the workers.
+/// @param encoder The parallel encoder which should be deallocated
+KODO_RLNC_API
+void krlnc_delete_parallel_encoder(krlnc_parallel_encoder_t encoder);
+
+/// Return the number of worker threads.
+/// @param encoder The parallel encoder to query
+/// @return The number of worker threads
+KODO_RLNC_API
+uint32_t krlnc_parallel_encoder_threads(krlnc_parallel_encoder_t encoder);
+
+/// Set the coding vector format used for all generations. This must not be
+/// called while generations are being encoded.
+/// @param encoder The parallel encoder which should be configured
+/// @param format_id The selected coding vector format
+KODO_RLNC_API
+void krlnc_parallel_encoder_set_coding_vector_format(
+    krlnc_parallel_encoder_t encoder, int32_t format_id);
+
+/// Switch the systematic encoding on for all generations. This must not be
+/// called while generations are being encoded.
+/// @param encoder The parallel encoder
+KODO_RLNC_API
+void krlnc_parallel_encoder_set_systematic_on(
+    krlnc_parallel_encoder_t encoder);
+
+/// Switch the systematic encoding off for all generations. This must not
+/// be called while generations are being encoded.
+/// @param encoder The parallel encoder
+KODO_RLNC_API
+void krlnc_parallel_encoder_set_systematic_off(
+    krlnc_parallel_encoder_t encoder);
+
+//------------------------------------------------------------------
+// DATA API
+//------------------------------------------------------------------
+
+/// Specify the data that should be encoded. The data is split into
+/// generations of symbols * symbol_size bytes. The buffer is not copied,
+/// so it must stay valid while the parallel encoder uses it. This must not
+/// be called while generations are being encoded.
+/// @param encoder The parallel encoder which will encode the data
+/// @param data The buffer containing the data to be encoded
+/// @param size The size of the data in bytes
+/// @return Non-zero if the data was accepted, or 0 if it would be split
+///         into more than 2^32 - 1 generations, in which case the data is
+///         unchanged
+KODO_RLNC_API
+uint8_t krlnc_parallel_encoder_set_data(
+    krlnc_parallel_encoder_t encoder, uint8_t* data, uint64_t size);
+
+/// Return the number of generations that the data is split into.
+/// @param encoder The parallel encoder to query
+/// @return The number of generations
+KODO_RLNC_API
+uint32_t krlnc_parallel_encoder_generations(krlnc_parallel_encoder_t encoder);
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+/// Return the maximum possible payload size of a parallel encoder, which
+/// includes the generation id that prefixes every payload. The payloads of
+/// a generation are stored with this stride.
+/// @param encoder The parallel encoder to query.
+/// @return The payload size in bytes
+KODO_RLNC_API
+uint32_t krlnc_parallel_encoder_max_payload_size(
+    krlnc_parallel_encoder_t encoder);
+
+/// Start encoding a range of generations on the worker threads. The
+/// function returns immediately. Each generation is encoded from the
+/// beginning, and the payloads of a generation become available through
+/// krlnc_parallel_encoder_collect() as soon as the generation is done.
+/// If the previous range is still being encoded, this function waits for
+/// it to finish, and its uncollected payloads are discarded.
+/// @param encoder The parallel encoder to use
+/// @param first_generation The index of the first generation to encode
+/// @param generations The number of generations to encode
+/// @param payloads The number of payloads to produce for each generation
+KODO_RLNC_API
+void krlnc_parallel_encoder_start(
+    krlnc_parallel_encoder_t encoder, uint32_t first_generation,
+    uint32_t generations, uint32_t payloads);
+
+/// Collect the payloads of the next completed generation without blocking.
+/// Generations are returned in the order they complete. The payloads stay
+/// valid until the next call to krlnc_parallel_encoder_start().
+/// @param encoder The parallel encoder to use
+/// @param generation The index of the completed generation
+/// @param payloads The payloads of the generation, which are stored with a
+///        stride of krlnc_parallel_encoder_max_payload_size()
+/// @param sizes The size of each payload
+/// @return Non-zero if a generation was collected, 0 if no completed
+///         generation is waiting
+KODO_RLNC_API
+uint8_t krlnc_parallel_encoder_collect(
+    krlnc_parallel_encoder_t encoder, uint32_t* generation,
+    const uint8_t** payloads, const uint32_t** sizes);
+
+/// Block until all the generations of the current range are encoded.
+/// @param encoder The parallel encoder to use
+KODO_RLNC_API
+void krlnc_parallel_encoder_wait(krlnc_parallel_encoder_t encoder);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,163 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include "payload_ring.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cassert>
+#include <vector>
+
+// The assumed size of a cache line. The indices of the producer and the
+// consumer are kept in separate cache lines, and so are the slots, so the
+// two threads do not invalidate each other's cache lines.
+static const uint32_t cache_line_size = 64;
+
+struct krlnc_payload_ring
+{
+    uint32_t m_slots = 0;
+    uint32_t m_mask = 0;
+    uint32_t m_slot_size = 0;
+    uint32_t m_stride = 0;
+
+    std::vector<uint8_t> m_buffer;
+    uint8_t* m_data = nullptr;
+    std::vector<uint32_t> m_sizes;
+
+    // The indices run freely and wrap around, the slot of an index is
+    // found with the mask. The producer owns m_tail and the consumer owns
+    // m_head. Each thread keeps a cached copy of the other index, which is
+    // only refreshed when the ring looks full or empty.
+    uint8_t m_padding0[cache_line_size];
+    std::atomic<uint32_t> m_tail{0};
+    uint32_t m_cached_head = 0;
+    uint8_t m_padding1[cache_line_size];
+    std::atomic<uint32_t> m_head{0};
+    uint32_t m_cached_tail = 0;
+    uint8_t m_padding2[cache_line_size];
+};
+
+//------------------------------------------------------------------
+// PAYLOAD RING API
+//------------------------------------------------------------------
+
+krlnc_payload_ring_t krlnc_create_payload_ring(
+    uint32_t slots, uint32_t slot_size)
+{
+    assert(slots > 0);
+    assert(slots <= (1U << 31));
+    assert(slot_size > 0);
+
+    auto ring = new krlnc_payload_ring();
+
+    ring->m_slots = 1;
+    while (ring->m_slots < slots)
+        ring->m_slots *= 2;
+
+    ring->m_mask = ring->m_slots - 1;
+    ring->m_slot_size = slot_size;
+    ring->m_stride = (slot_size + cache_line_size - 1) / cache_line_size *
+                     cache_line_size;
+
+    // The slots start at a cache line boundary
+    ring->m_buffer.resize(
+        uint64_t{ring->m_slots} * ring->m_stride + cache_line_size);
+    auto address = reinterpret_cast<uintptr_t>(ring->m_buffer.data());
+    ring->m_data = ring->m_buffer.data() +
+        (cache_line_size - address % cache_line_size) % cache_line_size;
+
+    ring->m_sizes.resize(ring->m_slots, 0);
+    return ring;
+}
+
+void krlnc_delete_payload_ring(krlnc_payload_ring_t ring)
+{
+    assert(ring != nullptr);
+    delete ring;
+}
+
+uint32_t krlnc_payload_ring_slots(krlnc_payload_ring_t ring)
+{
+    assert(ring != nullptr);
+    return ring->m_slots;
+}
+
+uint32_t krlnc_payload_ring_slot_size(krlnc_payload_ring_t ring)
+{
+    assert(ring != nullptr);
+    return ring->m_slot_size;
+}
+
+uint32_t krlnc_payload_ring_size(krlnc_payload_ring_t ring)
+{
+    assert(ring != nullptr);
+    uint32_t head = ring->m_head.load(std::memory_order_acquire);
+    uint32_t tail = ring->m_tail.load(std::memory_order_acquire);
+    return tail - head;
+}
+
+//------------------------------------------------------------------
+// PRODUCER API
+//------------------------------------------------------------------
+
+uint8_t* krlnc_payload_ring_acquire(krlnc_payload_ring_t ring)
+{
+    assert(ring != nullptr);
+
+    uint32_t tail = ring->m_tail.load(std::memory_order_relaxed);
+
+    if (tail - ring->m_cached_head == ring->m_slots)
+    {
+        ring->m_cached_head = ring->m_head.load(std::memory_order_acquire);
+        if (tail - ring->m_cached_head == ring->m_slots)
+            return nullptr;
+    }
+
+    return ring->m_data + uint64_t{tail & ring->m_mask} * ring->m_stride;
+}
+
+void krlnc_payload_ring_publish(krlnc_payload_ring_t ring, uint32_t size)
+{
+    assert(ring != nullptr);
+    assert(size <= ring->m_slot_size);
+
+    uint32_t tail = ring->m_tail.load(std::memory_order_relaxed);
+    assert(tail - ring->m_cached_head < ring->m_slots);
+
+    ring->m_sizes[tail & ring->m_mask] = size;
+    ring->m_tail.store(tail + 1, std::memory_order_release);
+}
+
+//------------------------------------------------------------------
+// CONSUMER API
+//------------------------------------------------------------------
+
+uint8_t* krlnc_payload_ring_peek(krlnc_payload_ring_t ring, uint32_t* size)
+{
+    assert(ring != nullptr);
+    assert(size != nullptr);
+
+    uint32_t head = ring->m_head.load(std::memory_order_relaxed);
+
+    if (head == ring->m_cached_tail)
+    {
+        ring->m_cached_tail = ring->m_tail.load(std::memory_order_acquire);
+        if (head == ring->m_cached_tail)
+            return nullptr;
+    }
+
+    *size = ring->m_sizes[head & ring->m_mask];
+    return ring->m_data + uint64_t{head & ring->m_mask} * ring->m_stride;
+}
+
+void krlnc_payload_ring_release(krlnc_payload_ring_t ring)
+{
+    assert(ring != nullptr);
+
+    uint32_t head = ring->m_head.load(std::memory_order_relaxed);
+    assert(head != ring->m_cached_tail);
+
+    ring->m_head.store(head + 1, std::memory_order_release);
+}
@@ -0,0 +1,108 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------
+// KODO-RLNC-C TYPES
+//------------------------------------------------------------------
+
+/// Opaque pointer used for payload ring
+typedef struct krlnc_payload_ring* krlnc_payload_ring_t;
+
+//------------------------------------------------------------------
+// PAYLOAD RING API
+//------------------------------------------------------------------
+
+/// Create a new payload ring. A payload ring hands payloads from one
+/// producer thread to one consumer thread, e.g. from a network thread to a
+/// coding thread, without locks or copies. The payloads are written and
+/// read in place in a fixed number of slots, which return to the producer
+/// when the consumer releases them.
+///
+/// Exactly one thread may call the producer functions and exactly one
+/// thread may call the consumer functions at any time.
+/// @param slots The number of slots, which is rounded up to a power of two
+/// @param slot_size The size of a slot in bytes, e.g. the value of
+///        krlnc_encoder_max_payload_size() or
+///        krlnc_decoder_max_payload_size()
+/// @return Pointer to a new payload ring instance.
+KODO_RLNC_API
+krlnc_payload_ring_t krlnc_create_payload_ring(
+    uint32_t slots, uint32_t slot_size);
+
+/// Deallocate and release the memory consumed by a payload ring. Neither
+/// thread may use the ring while it is deleted.
+/// @param ring The payload ring which should be deallocated
+KODO_RLNC_API
+void krlnc_delete_payload_ring(krlnc_payload_ring_t ring);
+
+/// Return the number of slots in the ring.
+/// @param ring The payload ring to query
+/// @return The number of slots
+KODO_RLNC_API
+uint32_t krlnc_payload_ring_slots(krlnc_payload_ring_t ring);
+
+/// Return the size of a slot in bytes.
+/// @param ring The payload ring to query
+/// @return The size of a slot in bytes
+KODO_RLNC_API
+uint32_t krlnc_payload_ring_slot_size(krlnc_payload_ring_t ring);
+
+/// Return the number of payloads that are published and not yet released.
+/// The value is exact for the calling thread if it is the producer or the
+/// consumer, otherwise it is only a snapshot.
+/// @param ring The payload ring to query
+/// @return The number of payloads in the ring
+KODO_RLNC_API
+uint32_t krlnc_payload_ring_size(krlnc_payload_ring_t ring);
+
+//------------------------------------------------------------------
+// PRODUCER API
+//------------------------------------------------------------------
+
+/// Return the next free slot, where the producer can write a payload. The
+/// same slot is returned until it is published.
+/// @param ring The payload ring to use
+/// @return The free slot, or NULL if all the slots are in use
+KODO_RLNC_API
+uint8_t* krlnc_payload_ring_acquire(krlnc_payload_ring_t ring);
+
+/// Hand the slot returned by krlnc_payload_ring_acquire() to the consumer.
+/// @param ring The payload ring to use
+/// @param size The number of bytes that were written to the slot
+KODO_RLNC_API
+void krlnc_payload_ring_publish(krlnc_payload_ring_t ring, uint32_t size);
+
+//------------------------------------------------------------------
+// CONSUMER API
+//------------------------------------------------------------------
+
+/// Return the oldest published payload. The same payload is returned until
+/// it is released. The consumer may change the payload in place, e.g. with
+/// krlnc_decoder_consume_payload().
+/// @param ring The payload ring to use
+/// @param size Set to the size of the payload in bytes
+/// @return The payload, or NULL if no payload is published
+KODO_RLNC_API
+uint8_t* krlnc_payload_ring_peek(krlnc_payload_ring_t ring, uint32_t* size);
+
+/// Hand the slot returned by krlnc_payload_ring_peek() back to the
+/// producer.
+/// @param ring The payload ring to use
+KODO_RLNC_API
+void krlnc_payload_ring_release(krlnc_payload_ring_t ring);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,241 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include "recoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include <random>
+#include <vector>
+
+#include "detail/elimination.hpp"
+#include "detail/segmented_payload.hpp"
+
+struct krlnc_recoder
+{
+    krlnc_recoder(uint32_t symbols, uint32_t symbol_size,
+                  uint32_t capacity) :
+        m_symbols(symbols),
+        m_symbol_size(symbol_size),
+        m_capacity(capacity),
+        m_vector(symbols + symbol_size),
+        m_random(std::random_device()())
+    { }
+
+    uint32_t m_symbols;
+    uint32_t m_symbol_size;
+    uint32_t m_capacity;
+    elimination m_field;
+
+    // The stored payloads in echelon form. A row consists of the
+    // coefficients followed by the symbol, and the rows are allocated as
+    // they are needed. The order lists the rows by increasing pivot.
+    std::vector<uint8_t> m_rows;
+    std::vector<uint32_t> m_pivots;
+    std::vector<uint32_t> m_order;
+    uint32_t m_rank = 0;
+
+    // The payload that is being consumed
+    std::vector<uint8_t> m_vector;
+
+    // Seeded randomly, so that recoders do not send the same combinations
+    std::mt19937 m_random;
+};
+
+static uint8_t* row(krlnc_recoder_t recoder, uint32_t index)
+{
+    uint64_t row_size = uint64_t(recoder->m_symbols) + recoder->m_symbol_size;
+    return recoder->m_rows.data() + index * row_size;
+}
+
+//------------------------------------------------------------------
+// RECODER BASIC API
+//------------------------------------------------------------------
+
+krlnc_recoder_t krlnc_create_recoder(
+    uint32_t symbols, uint32_t symbol_size, uint32_t capacity)
+{
+    assert(symbols > 0);
+    assert(symbol_size > 0);
+
+    if (capacity == 0 || capacity > symbols)
+        capacity = symbols;
+
+    return new krlnc_recoder(symbols, symbol_size, capacity);
+}
+
+void krlnc_delete_recoder(krlnc_recoder_t recoder)
+{
+    assert(recoder != nullptr);
+    delete recoder;
+}
+
+void krlnc_reset_recoder(krlnc_recoder_t recoder)
+{
+    assert(recoder != nullptr);
+    recoder->m_pivots.clear();
+    recoder->m_order.clear();
+    recoder->m_rank = 0;
+}
+
+uint32_t krlnc_recoder_symbols(krlnc_recoder_t recoder)
+{
+    assert(recoder != nullptr);
+    return recoder->m_symbols;
+}
+
+uint32_t krlnc_recoder_symbol_size(krlnc_recoder_t recoder)
+{
+    assert(recoder != nullptr);
+    return recoder->m_symbol_size;
+}
+
+uint32_t krlnc_recoder_capacity(krlnc_recoder_t recoder)
+{
+    assert(recoder != nullptr);
+    return recoder->m_capacity;
+}
+
+uint32_t krlnc_recoder_rank(krlnc_recoder_t recoder)
+{
+    assert(recoder != nullptr);
+    return recoder->m_rank;
+}
+
+void krlnc_recoder_set_seed(krlnc_recoder_t recoder, uint32_t seed_value)
+{
+    assert(recoder != nullptr);
+    recoder->m_random.seed(seed_value);
+}
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+uint32_t krlnc_recoder_max_payload_size(krlnc_recoder_t recoder)
+{
+    assert(recoder != nullptr);
+    return max_segmented_header_size(recoder->m_symbols) +
+           recoder->m_symbol_size;
+}
+
+void krlnc_recoder_consume_payload(
+    krlnc_recoder_t recoder, const uint8_t* payload, uint32_t payload_size)
+{
+    assert(recoder != nullptr);
+    assert(payload != nullptr);
+
+    uint32_t symbols = recoder->m_symbols;
+    uint32_t symbol_size = recoder->m_symbol_size;
+    uint32_t row_size = symbols + symbol_size;
+
+    if (payload_size == 0 || recoder->m_rank == recoder->m_capacity)
+        return;
+
+    // Expand the payload to a coefficient vector followed by the symbol
+    uint8_t* vector = recoder->m_vector.data();
+
+    if (payload[0] == segmented_systematic)
+    {
+        uint32_t header_size = 1 + sizeof(uint32_t);
+        if (payload_size < header_size + symbol_size)
+            return;
+
+        uint32_t index = read_uint32(payload + 1);
+        if (index >= symbols)
+            return;
+
+        std::fill_n(vector, symbols, 0);
+        vector[index] = 1;
+        std::copy_n(payload + header_size, symbol_size, vector + symbols);
+    }
+    else if (payload[0] == segmented_coded)
+    {
+        if (payload_size < 1 + row_size)
+            return;
+
+        std::copy_n(payload + 1, row_size, vector);
+    }
+    else
+    {
+        return;
+    }
+
+    // Reduce the payload with the stored rows by increasing pivot. The
+    // first non-zero coefficient of the payload only moves forward.
+    const elimination& field = recoder->m_field;
+    uint32_t pivot = 0;
+    uint32_t position = 0;
+
+    for (; position < recoder->m_rank; ++position)
+    {
+        pivot = elimination::find_pivot(vector, pivot, symbols);
+
+        // The payload is linearly dependent
+        if (pivot == symbols)
+            return;
+
+        // The payload has no row for its first coefficient, so that
+        // becomes the pivot of a new row before this one
+        uint32_t index = recoder->m_order[position];
+        uint32_t row_pivot = recoder->m_pivots[index];
+        if (pivot < row_pivot)
+            break;
+
+        field.multiply_add(vector, row(recoder, index), vector[row_pivot],
+                           row_size);
+    }
+
+    pivot = elimination::find_pivot(vector, pivot, symbols);
+    if (pivot == symbols)
+        return;
+
+    field.normalize_row(vector, vector + symbols, pivot, symbols,
+                        symbol_size);
+
+    // The new row is in echelon form without being reduced by the rows
+    // after it, since they have no coefficients before their pivots
+    uint32_t index = recoder->m_rank;
+    uint64_t rows_size = (uint64_t(index) + 1) * row_size;
+    if (recoder->m_rows.size() < rows_size)
+        recoder->m_rows.resize(rows_size);
+
+    std::copy_n(vector, row_size, row(recoder, index));
+
+    if (recoder->m_pivots.size() <= index)
+        recoder->m_pivots.resize(index + 1);
+    recoder->m_pivots[index] = pivot;
+
+    recoder->m_order.insert(recoder->m_order.begin() + position, index);
+    ++recoder->m_rank;
+}
+
+uint32_t krlnc_recoder_produce_payload(
+    krlnc_recoder_t recoder, uint8_t* payload)
+{
+    assert(recoder != nullptr);
+    assert(payload != nullptr);
+
+    if (recoder->m_rank == 0)
+        return 0;
+
+    uint32_t row_size = recoder->m_symbols + recoder->m_symbol_size;
+    uint8_t* vector = payload + 1;
+
+    payload[0] = segmented_coded;
+    std::fill_n(vector, row_size, 0);
+
+    const elimination& field = recoder->m_field;
+    for (uint32_t index = 0; index < recoder->m_rank; ++index)
+    {
+        uint8_t coefficient = static_cast<uint8_t>(recoder->m_random());
+        field.multiply_add(vector, row(recoder, index), coefficient,
+                           row_size);
+    }
+
+    return 1 + row_size;
+}
@@ -0,0 +1,124 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------
+// KODO-RLNC-C TYPES
+//------------------------------------------------------------------
+
+/// Opaque pointer used for recoder
+typedef struct krlnc_recoder* krlnc_recoder_t;
+
+//------------------------------------------------------------------
+// RECODER BASIC API
+//------------------------------------------------------------------
+
+/// Create a new recoder object. A recoder is used by relays that forward
+/// coded data without decoding it. It stores the innovative payloads it
+/// receives in echelon form, which is enough to detect and drop linearly
+/// dependent payloads, and it never substitutes backwards or stores
+/// decoded symbols. The buffers are allocated as innovative payloads
+/// arrive, up to the given capacity.
+///
+/// A recoder only supports the binary8 field. It consumes and produces
+/// segmented payloads, see krlnc_encoder_produce_payload_segments() and
+/// krlnc_decoder_consume_segmented_payload(), but not the payloads of
+/// krlnc_encoder_produce_payload(), since their format is internal to kodo.
+/// @param symbols The number of symbols in a generation
+/// @param symbol_size The size of a symbol in bytes
+/// @param capacity The maximum number of payloads to store. If 0, a
+///        buffer for every symbol can be allocated.
+/// @return Pointer to a new recoder instance.
+KODO_RLNC_API
+krlnc_recoder_t krlnc_create_recoder(
+    uint32_t symbols, uint32_t symbol_size, uint32_t capacity);
+
+/// Deallocate and release the memory consumed by a recoder
+/// @param recoder The recoder which should be deallocated
+KODO_RLNC_API
+void krlnc_delete_recoder(krlnc_recoder_t recoder);
+
+/// Reset the recoder so that it can be used for a new generation. The
+/// allocated buffers are kept.
+/// @param recoder The recoder which should be reset
+KODO_RLNC_API
+void krlnc_reset_recoder(krlnc_recoder_t recoder);
+
+/// Return the number of symbols in a generation.
+/// @param recoder The recoder to query
+/// @return The number of symbols
+KODO_RLNC_API
+uint32_t krlnc_recoder_symbols(krlnc_recoder_t recoder);
+
+/// Return the symbol size of the recoder.
+/// @param recoder The recoder to query
+/// @return The size of a symbol in bytes
+KODO_RLNC_API
+uint32_t krlnc_recoder_symbol_size(krlnc_recoder_t recoder);
+
+/// Return the maximum number of payloads that the recoder stores.
+/// @param recoder The recoder to query
+/// @return The capacity of the recoder
+KODO_RLNC_API
+uint32_t krlnc_recoder_capacity(krlnc_recoder_t recoder);
+
+/// Return the rank of the recoder, i.e. the number of linearly
+/// independent payloads that it stores.
+/// @param recoder The recoder to query
+/// @return The rank of the recoder
+KODO_RLNC_API
+uint32_t krlnc_recoder_rank(krlnc_recoder_t recoder);
+
+/// Set the seed of the coefficient generator. A new recoder is seeded
+/// randomly, so different recoders produce different combinations unless
+/// they are given the same seed.
+/// @param recoder The recoder to use
+/// @param seed_value The seed value for the generator.
+KODO_RLNC_API
+void krlnc_recoder_set_seed(krlnc_recoder_t recoder, uint32_t seed_value);
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+/// Return the maximum size of a segmented payload.
+/// @param recoder The recoder to query.
+/// @return The payload size in bytes
+KODO_RLNC_API
+uint32_t krlnc_recoder_max_payload_size(krlnc_recoder_t recoder);
+
+/// Consume a segmented payload. The payload is not changed. Linearly
+/// dependent payloads are dropped, and so are innovative payloads once the
+/// recoder is full. Invalid payloads are ignored.
+/// @param recoder The recoder to use.
+/// @param payload The buffer storing the payload.
+/// @param payload_size The size of the payload in bytes
+KODO_RLNC_API
+void krlnc_recoder_consume_payload(
+    krlnc_recoder_t recoder, const uint8_t* payload, uint32_t payload_size);
+
+/// Produce a segmented payload that is a random combination of the stored
+/// payloads.
+/// @param recoder The recoder to use.
+/// @param payload The buffer which should contain the payload. It must
+///        have a capacity of at least krlnc_recoder_max_payload_size().
+/// @return The total bytes used from the payload buffer, or 0 if the
+///         recoder has not stored any payloads
+KODO_RLNC_API
+uint32_t krlnc_recoder_produce_payload(
+    krlnc_recoder_t recoder, uint8_t* payload);
+
+#ifdef __cplusplus
+}
+#endif
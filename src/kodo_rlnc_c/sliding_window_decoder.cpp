@@ -0,0 +1,454 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include "sliding_window_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include <vector>
+
+#include "detail/elimination.hpp"
+#include "detail/sliding_window_payload.hpp"
+
+struct krlnc_sliding_window_decoder
+{
+    krlnc_sliding_window_decoder(uint32_t capacity, uint32_t symbol_size) :
+        m_capacity(capacity),
+        m_symbol_size(symbol_size),
+        m_coefficients(capacity * capacity),
+        m_symbols(capacity * symbol_size),
+        m_pivot(capacity, false),
+        m_decoded(capacity, false),
+        m_retired(capacity * symbol_size),
+        m_retired_known(capacity, false),
+        m_vector(capacity),
+        m_symbol(symbol_size)
+    { }
+
+    uint32_t m_capacity;
+    uint32_t m_symbol_size;
+    elimination m_field;
+
+    // The decoding matrix in reduced echelon form. The symbols in the
+    // window are stored in a ring, where the first symbol of the window is
+    // stored in m_first_slot. Both the rows and the columns of the matrix
+    // are indexed by slot, and a row is only valid if it is a pivot.
+    std::vector<uint8_t> m_coefficients;
+    std::vector<uint8_t> m_symbols;
+    std::vector<bool> m_pivot;
+    std::vector<bool> m_decoded;
+    uint32_t m_first_slot = 0;
+    uint32_t m_rank = 0;
+
+    // The sequence numbers of the first symbol in the window and the
+    // symbol after the last one that has been seen
+    uint32_t m_start = 0;
+    uint32_t m_end = 0;
+
+    // The symbols from m_retired_start to m_start were retired, but the
+    // encoder may still code over them. The data of the ones that were
+    // decoded is kept in the slot of their sequence number modulo the
+    // capacity, until the window of an incoming coded payload starts after
+    // them.
+    std::vector<uint8_t> m_retired;
+    std::vector<bool> m_retired_known;
+    uint32_t m_retired_start = 0;
+
+    // The payload that is being decoded
+    std::vector<uint8_t> m_vector;
+    std::vector<uint8_t> m_symbol;
+};
+
+// Return the slot of the symbol with the given offset from the start of
+// the window
+static uint32_t window_slot(
+    krlnc_sliding_window_decoder_t decoder, uint32_t offset)
+{
+    return (decoder->m_first_slot + offset) % decoder->m_capacity;
+}
+
+static uint8_t* row_coefficients(
+    krlnc_sliding_window_decoder_t decoder, uint32_t slot)
+{
+    return decoder->m_coefficients.data() + slot * decoder->m_capacity;
+}
+
+static uint8_t* row_symbol(
+    krlnc_sliding_window_decoder_t decoder, uint32_t slot)
+{
+    return decoder->m_symbols.data() + slot * decoder->m_symbol_size;
+}
+
+// A row is decoded when its pivot is its only non-zero coefficient
+static void update_decoded(
+    krlnc_sliding_window_decoder_t decoder, uint32_t slot)
+{
+    const uint8_t* coefficients = row_coefficients(decoder, slot);
+
+    for (uint32_t column = 0; column < decoder->m_capacity; ++column)
+    {
+        if (column != slot && coefficients[column] != 0)
+        {
+            decoder->m_decoded[slot] = false;
+            return;
+        }
+    }
+    decoder->m_decoded[slot] = true;
+}
+
+// Return the data of a retired symbol that was decoded, or nullptr if the
+// symbol is not known
+static const uint8_t* retired_symbol(
+    krlnc_sliding_window_decoder_t decoder, uint32_t sequence)
+{
+    if (static_cast<int32_t>(sequence - decoder->m_retired_start) < 0 ||
+        static_cast<int32_t>(sequence - decoder->m_start) >= 0)
+    {
+        return nullptr;
+    }
+
+    uint32_t slot = sequence % decoder->m_capacity;
+    if (!decoder->m_retired_known[slot])
+        return nullptr;
+
+    return decoder->m_retired.data() + slot * decoder->m_symbol_size;
+}
+
+// Keep the data of a symbol that leaves the window if it is decoded
+static void retire_symbol(
+    krlnc_sliding_window_decoder_t decoder, uint32_t sequence,
+    uint32_t column)
+{
+    uint32_t slot = sequence % decoder->m_capacity;
+    bool known = decoder->m_pivot[column] && decoder->m_decoded[column];
+    decoder->m_retired_known[slot] = known;
+
+    if (known)
+    {
+        std::copy_n(row_symbol(decoder, column), decoder->m_symbol_size,
+                    decoder->m_retired.begin() +
+                    slot * decoder->m_symbol_size);
+    }
+}
+
+static void remove_row(krlnc_sliding_window_decoder_t decoder, uint32_t slot)
+{
+    if (!decoder->m_pivot[slot])
+        return;
+
+    decoder->m_pivot[slot] = false;
+    decoder->m_decoded[slot] = false;
+    --decoder->m_rank;
+}
+
+// Move the start of the window forward to the given sequence number. The
+// rows that depend on a dropped symbol can no longer be decoded, so they
+// are dropped as well. Decoded symbols never have such dependents, and
+// their data is kept, see retire_symbol().
+static void drop_symbols(
+    krlnc_sliding_window_decoder_t decoder, uint32_t sequence)
+{
+    uint32_t capacity = decoder->m_capacity;
+    uint32_t distance = sequence - decoder->m_start;
+    uint32_t dropped =
+        std::min(distance, decoder->m_end - decoder->m_start);
+
+    for (uint32_t offset = 0; offset < dropped; ++offset)
+    {
+        uint32_t column = window_slot(decoder, offset);
+        retire_symbol(decoder, decoder->m_start + offset, column);
+        remove_row(decoder, column);
+
+        for (uint32_t slot = 0; slot < decoder->m_capacity; ++slot)
+        {
+            if (decoder->m_pivot[slot] &&
+                row_coefficients(decoder, slot)[column] != 0)
+            {
+                remove_row(decoder, slot);
+            }
+        }
+    }
+
+    // The symbols that were never seen are not known, and only the last
+    // capacity symbols before the window are kept
+    uint32_t unseen =
+        std::max(dropped, distance - std::min(distance, capacity));
+    for (uint32_t offset = unseen; offset < distance; ++offset)
+    {
+        uint32_t slot = (decoder->m_start + offset) % capacity;
+        decoder->m_retired_known[slot] = false;
+    }
+
+    if (sequence - decoder->m_retired_start > capacity)
+        decoder->m_retired_start = sequence - capacity;
+
+    decoder->m_start = sequence;
+    decoder->m_first_slot =
+        (decoder->m_first_slot + distance % decoder->m_capacity) %
+        decoder->m_capacity;
+
+    if (static_cast<int32_t>(decoder->m_end - decoder->m_start) < 0)
+        decoder->m_end = decoder->m_start;
+}
+
+//------------------------------------------------------------------
+// SLIDING WINDOW DECODER BASIC API
+//------------------------------------------------------------------
+
+krlnc_sliding_window_decoder_t krlnc_create_sliding_window_decoder(
+    uint32_t capacity, uint32_t symbol_size)
+{
+    assert(capacity > 0);
+    assert(symbol_size > 0);
+    return new krlnc_sliding_window_decoder(capacity, symbol_size);
+}
+
+void krlnc_delete_sliding_window_decoder(
+    krlnc_sliding_window_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    delete decoder;
+}
+
+uint32_t krlnc_sliding_window_decoder_capacity(
+    krlnc_sliding_window_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_capacity;
+}
+
+uint32_t krlnc_sliding_window_decoder_symbol_size(
+    krlnc_sliding_window_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_symbol_size;
+}
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+uint32_t krlnc_sliding_window_decoder_max_payload_size(
+    krlnc_sliding_window_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return sliding_window_max_payload_size(
+        decoder->m_capacity, decoder->m_symbol_size);
+}
+
+void krlnc_sliding_window_decoder_consume_payload(
+    krlnc_sliding_window_decoder_t decoder, const uint8_t* payload,
+    uint32_t payload_size)
+{
+    assert(decoder != nullptr);
+    assert(payload != nullptr);
+
+    uint32_t capacity = decoder->m_capacity;
+    uint32_t symbol_size = decoder->m_symbol_size;
+
+    if (payload_size < sliding_window_bounds_size)
+        return;
+
+    uint32_t start = read_uint32(payload);
+    uint32_t size = read_uint32(payload + sizeof(uint32_t));
+
+    if (size == 0 || size > capacity ||
+        payload_size < sliding_window_bounds_size + size + symbol_size)
+    {
+        return;
+    }
+
+    const uint8_t* coefficients = payload + sliding_window_bounds_size;
+    const uint8_t* symbol = coefficients + size;
+
+    // The symbols before the window were retired, so the payload is only
+    // useful if the ones it depends on were decoded
+    uint32_t skipped = 0;
+    if (static_cast<int32_t>(decoder->m_start - start) > 0)
+    {
+        skipped = std::min(decoder->m_start - start, size);
+        for (uint32_t i = 0; i < skipped; ++i)
+        {
+            if (coefficients[i] != 0 &&
+                retired_symbol(decoder, start + i) == nullptr)
+            {
+                return;
+            }
+        }
+    }
+
+    // A coded window starts at the window of the encoder, which has retired
+    // the symbols before it, so they are no longer needed. A systematic
+    // symbol is sent as a window of one, which says nothing about that.
+    if (size > 1 &&
+        static_cast<int32_t>(start - decoder->m_retired_start) > 0)
+    {
+        decoder->m_retired_start =
+            static_cast<int32_t>(start - decoder->m_start) > 0 ?
+            decoder->m_start : start;
+    }
+
+    // Slide the window forward if the payload covers new symbols
+    uint32_t end = start + size;
+    if (static_cast<int32_t>(end - decoder->m_end) > 0)
+    {
+        if (end - decoder->m_start > capacity)
+            drop_symbols(decoder, end - capacity);
+        decoder->m_end = end;
+    }
+
+    std::fill(decoder->m_vector.begin(), decoder->m_vector.end(), 0);
+    for (uint32_t i = skipped; i < size; ++i)
+    {
+        uint32_t slot = window_slot(decoder, start + i - decoder->m_start);
+        decoder->m_vector[slot] = coefficients[i];
+    }
+    std::copy_n(symbol, symbol_size, decoder->m_symbol.begin());
+
+    uint8_t* vector = decoder->m_vector.data();
+    uint8_t* vector_symbol = decoder->m_symbol.data();
+    const elimination& field = decoder->m_field;
+
+    // Subtract the retired symbols that the payload still includes
+    for (uint32_t i = 0; i < skipped; ++i)
+    {
+        if (coefficients[i] == 0)
+            continue;
+
+        field.multiply_add(vector_symbol, retired_symbol(decoder, start + i),
+                           coefficients[i], symbol_size);
+    }
+
+    // Eliminate the pivots of the payload. Every row has zeros in the
+    // pivot columns of the other rows, so each pivot is eliminated with a
+    // single row operation.
+    uint32_t window = decoder->m_end - decoder->m_start;
+    for (uint32_t offset = 0; offset < window; ++offset)
+    {
+        uint32_t slot = window_slot(decoder, offset);
+        uint8_t coefficient = vector[slot];
+
+        if (coefficient == 0 || !decoder->m_pivot[slot])
+            continue;
+
+        field.subtract_row(vector, vector_symbol,
+                           row_coefficients(decoder, slot),
+                           row_symbol(decoder, slot), coefficient, capacity,
+                           symbol_size);
+    }
+
+    // The first remaining coefficient becomes the pivot of the new row
+    uint32_t pivot = capacity;
+    for (uint32_t offset = 0; offset < window; ++offset)
+    {
+        uint32_t slot = window_slot(decoder, offset);
+        if (vector[slot] != 0)
+        {
+            pivot = slot;
+            break;
+        }
+    }
+
+    // The payload is linearly dependent
+    if (pivot == capacity)
+        return;
+
+    field.normalize_row(vector, vector_symbol, pivot, capacity, symbol_size);
+
+    // Substitute the new row back into the rows that use its pivot
+    for (uint32_t slot = 0; slot < capacity; ++slot)
+    {
+        uint8_t* row = row_coefficients(decoder, slot);
+        if (!decoder->m_pivot[slot] || row[pivot] == 0)
+            continue;
+
+        field.subtract_row(row, row_symbol(decoder, slot), vector,
+                           vector_symbol, row[pivot], capacity, symbol_size);
+        update_decoded(decoder, slot);
+    }
+
+    std::copy_n(vector, capacity, row_coefficients(decoder, pivot));
+    std::copy_n(vector_symbol, symbol_size, row_symbol(decoder, pivot));
+    decoder->m_pivot[pivot] = true;
+    ++decoder->m_rank;
+    update_decoded(decoder, pivot);
+}
+
+//------------------------------------------------------------------
+// WINDOW API
+//------------------------------------------------------------------
+
+uint32_t krlnc_sliding_window_decoder_window_start(
+    krlnc_sliding_window_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_start;
+}
+
+uint32_t krlnc_sliding_window_decoder_window_end(
+    krlnc_sliding_window_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_end;
+}
+
+uint32_t krlnc_sliding_window_decoder_rank(
+    krlnc_sliding_window_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+    return decoder->m_rank;
+}
+
+uint8_t krlnc_sliding_window_decoder_is_symbol_decoded(
+    krlnc_sliding_window_decoder_t decoder, uint32_t sequence)
+{
+    assert(decoder != nullptr);
+
+    uint32_t offset = sequence - decoder->m_start;
+    if (offset >= decoder->m_end - decoder->m_start)
+        return 0;
+
+    return decoder->m_decoded[window_slot(decoder, offset)];
+}
+
+const uint8_t* krlnc_sliding_window_decoder_symbol_data(
+    krlnc_sliding_window_decoder_t decoder, uint32_t sequence)
+{
+    assert(decoder != nullptr);
+
+    if (!krlnc_sliding_window_decoder_is_symbol_decoded(decoder, sequence))
+        return nullptr;
+
+    uint32_t offset = sequence - decoder->m_start;
+    return row_symbol(decoder, window_slot(decoder, offset));
+}
+
+uint32_t krlnc_sliding_window_decoder_next_missing_symbol(
+    krlnc_sliding_window_decoder_t decoder)
+{
+    assert(decoder != nullptr);
+
+    uint32_t window = decoder->m_end - decoder->m_start;
+    for (uint32_t offset = 0; offset < window; ++offset)
+    {
+        if (!decoder->m_decoded[window_slot(decoder, offset)])
+            return decoder->m_start + offset;
+    }
+    return decoder->m_end;
+}
+
+void krlnc_sliding_window_decoder_retire_symbols(
+    krlnc_sliding_window_decoder_t decoder, uint32_t sequence)
+{
+    assert(decoder != nullptr);
+
+    // Sequence numbers are compared by their distance, so they can wrap
+    if (static_cast<int32_t>(sequence - decoder->m_start) <= 0)
+        return;
+
+    drop_symbols(decoder, sequence);
+}
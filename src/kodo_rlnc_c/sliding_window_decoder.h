@@ -0,0 +1,151 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------
+// KODO-RLNC-C TYPES
+//------------------------------------------------------------------
+
+/// Opaque pointer used for sliding window decoder
+typedef struct krlnc_sliding_window_decoder*
+    krlnc_sliding_window_decoder_t;
+
+//------------------------------------------------------------------
+// SLIDING WINDOW DECODER BASIC API
+//------------------------------------------------------------------
+
+/// Create a new sliding window decoder object, which decodes the payloads
+/// of a sliding window encoder with the same capacity and symbol size.
+/// The decoder keeps a window of at most capacity symbols. When a payload
+/// covers symbols beyond the end of the window, the window slides forward
+/// and the oldest symbols are dropped, even if they are not decoded.
+/// @param capacity The maximum number of symbols in the window
+/// @param symbol_size The size of a symbol in bytes
+/// @return Pointer to a new sliding window decoder instance.
+KODO_RLNC_API
+krlnc_sliding_window_decoder_t krlnc_create_sliding_window_decoder(
+    uint32_t capacity, uint32_t symbol_size);
+
+/// Deallocate and release the memory consumed by a sliding window decoder
+/// @param decoder The sliding window decoder which should be deallocated
+KODO_RLNC_API
+void krlnc_delete_sliding_window_decoder(
+    krlnc_sliding_window_decoder_t decoder);
+
+/// Return the maximum number of symbols in the window.
+/// @param decoder The sliding window decoder to query
+/// @return The capacity of the window
+KODO_RLNC_API
+uint32_t krlnc_sliding_window_decoder_capacity(
+    krlnc_sliding_window_decoder_t decoder);
+
+/// Return the symbol size of the decoder.
+/// @param decoder The sliding window decoder to query
+/// @return The size of a symbol in bytes
+KODO_RLNC_API
+uint32_t krlnc_sliding_window_decoder_symbol_size(
+    krlnc_sliding_window_decoder_t decoder);
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+/// Return the maximum possible payload size of a sliding window decoder.
+/// @param decoder The sliding window decoder to query.
+/// @return The payload size in bytes
+KODO_RLNC_API
+uint32_t krlnc_sliding_window_decoder_max_payload_size(
+    krlnc_sliding_window_decoder_t decoder);
+
+/// Consume a payload that was produced by a sliding window encoder. The
+/// payload is not changed. The retired symbols that were decoded are
+/// subtracted from payloads that still include them. Invalid payloads, and
+/// payloads that depend on retired symbols that were not decoded, are
+/// ignored.
+/// @param decoder The sliding window decoder to use.
+/// @param payload The buffer storing the payload.
+/// @param payload_size The size of the payload in bytes
+KODO_RLNC_API
+void krlnc_sliding_window_decoder_consume_payload(
+    krlnc_sliding_window_decoder_t decoder, const uint8_t* payload,
+    uint32_t payload_size);
+
+//------------------------------------------------------------------
+// WINDOW API
+//------------------------------------------------------------------
+
+/// Return the sequence number of the first symbol in the window.
+/// @param decoder The sliding window decoder to query
+/// @return The sequence number of the first symbol
+KODO_RLNC_API
+uint32_t krlnc_sliding_window_decoder_window_start(
+    krlnc_sliding_window_decoder_t decoder);
+
+/// Return the sequence number after the last symbol that the decoder has
+/// seen in a payload.
+/// @param decoder The sliding window decoder to query
+/// @return The sequence number after the last symbol
+KODO_RLNC_API
+uint32_t krlnc_sliding_window_decoder_window_end(
+    krlnc_sliding_window_decoder_t decoder);
+
+/// Return the rank of the decoder, i.e. the number of linearly independent
+/// payloads it holds for the symbols in the window.
+/// @param decoder The sliding window decoder to query
+/// @return The rank of the decoder
+KODO_RLNC_API
+uint32_t krlnc_sliding_window_decoder_rank(
+    krlnc_sliding_window_decoder_t decoder);
+
+/// Indicates whether a symbol in the window has been decoded.
+/// @param decoder The sliding window decoder to query
+/// @param sequence The sequence number of the symbol
+/// @return Non-zero if the symbol is in the window and decoded, otherwise 0
+KODO_RLNC_API
+uint8_t krlnc_sliding_window_decoder_is_symbol_decoded(
+    krlnc_sliding_window_decoder_t decoder, uint32_t sequence);
+
+/// Return the data of a decoded symbol. The data stays valid until the
+/// symbol is retired or dropped from the window.
+/// @param decoder The sliding window decoder to query
+/// @param sequence The sequence number of the symbol
+/// @return The symbol data, or NULL if the symbol is not decoded
+KODO_RLNC_API
+const uint8_t* krlnc_sliding_window_decoder_symbol_data(
+    krlnc_sliding_window_decoder_t decoder, uint32_t sequence);
+
+/// Return the sequence number of the first symbol in the window that is
+/// not decoded. All symbols before it are decoded, so they can be
+/// delivered in order, retired and acknowledged to the encoder.
+/// @param decoder The sliding window decoder to query
+/// @return The sequence number of the first missing symbol, or the window
+///         end if all symbols are decoded
+KODO_RLNC_API
+uint32_t krlnc_sliding_window_decoder_next_missing_symbol(
+    krlnc_sliding_window_decoder_t decoder);
+
+/// Retire all symbols with a sequence number before the given one, which
+/// makes room for new symbols in the window. Symbols that are retired
+/// before they are decoded are lost. The data of decoded symbols is kept
+/// internally until the window of an incoming coded payload starts after
+/// them, so the decoder can retire symbols before the encoder does.
+/// @param decoder The sliding window decoder to use
+/// @param sequence The sequence number of the first symbol to keep
+KODO_RLNC_API
+void krlnc_sliding_window_decoder_retire_symbols(
+    krlnc_sliding_window_decoder_t decoder, uint32_t sequence);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,219 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include "sliding_window_encoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include <random>
+#include <vector>
+
+#include "detail/elimination.hpp"
+#include "detail/sliding_window_payload.hpp"
+
+struct krlnc_sliding_window_encoder
+{
+    krlnc_sliding_window_encoder(uint32_t capacity, uint32_t symbol_size) :
+        m_capacity(capacity),
+        m_symbol_size(symbol_size),
+        m_symbols(capacity * symbol_size)
+    { }
+
+    uint32_t m_capacity;
+    uint32_t m_symbol_size;
+    elimination m_field;
+
+    // The symbols in the window are stored in a ring, where the first
+    // symbol of the window is stored in m_first_slot
+    std::vector<uint8_t> m_symbols;
+    uint32_t m_first_slot = 0;
+
+    // The sequence numbers of the first symbol in the window and the next
+    // symbol to be pushed
+    uint32_t m_start = 0;
+    uint32_t m_end = 0;
+
+    // The sequence number of the next symbol to send uncoded
+    uint32_t m_next_systematic = 0;
+    bool m_systematic = true;
+
+    std::mt19937 m_random;
+};
+
+// Return the symbol with the given offset from the start of the window
+static uint8_t* window_symbol(
+    krlnc_sliding_window_encoder_t encoder, uint32_t offset)
+{
+    uint32_t slot = (encoder->m_first_slot + offset) % encoder->m_capacity;
+    return encoder->m_symbols.data() + slot * encoder->m_symbol_size;
+}
+
+//------------------------------------------------------------------
+// SLIDING WINDOW ENCODER BASIC API
+//------------------------------------------------------------------
+
+krlnc_sliding_window_encoder_t krlnc_create_sliding_window_encoder(
+    uint32_t capacity, uint32_t symbol_size)
+{
+    assert(capacity > 0);
+    assert(symbol_size > 0);
+    return new krlnc_sliding_window_encoder(capacity, symbol_size);
+}
+
+void krlnc_delete_sliding_window_encoder(
+    krlnc_sliding_window_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    delete encoder;
+}
+
+uint32_t krlnc_sliding_window_encoder_capacity(
+    krlnc_sliding_window_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return encoder->m_capacity;
+}
+
+uint32_t krlnc_sliding_window_encoder_symbol_size(
+    krlnc_sliding_window_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return encoder->m_symbol_size;
+}
+
+void krlnc_sliding_window_encoder_set_systematic_on(
+    krlnc_sliding_window_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    encoder->m_systematic = true;
+}
+
+void krlnc_sliding_window_encoder_set_systematic_off(
+    krlnc_sliding_window_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    encoder->m_systematic = false;
+}
+
+void krlnc_sliding_window_encoder_set_seed(
+    krlnc_sliding_window_encoder_t encoder, uint32_t seed_value)
+{
+    assert(encoder != nullptr);
+    encoder->m_random.seed(seed_value);
+}
+
+//------------------------------------------------------------------
+// WINDOW API
+//------------------------------------------------------------------
+
+uint8_t krlnc_sliding_window_encoder_push_symbol(
+    krlnc_sliding_window_encoder_t encoder, const uint8_t* symbol)
+{
+    assert(encoder != nullptr);
+    assert(symbol != nullptr);
+
+    uint32_t size = encoder->m_end - encoder->m_start;
+    if (size == encoder->m_capacity)
+        return 0;
+
+    std::memcpy(window_symbol(encoder, size), symbol, encoder->m_symbol_size);
+    ++encoder->m_end;
+    return 1;
+}
+
+void krlnc_sliding_window_encoder_retire_symbols(
+    krlnc_sliding_window_encoder_t encoder, uint32_t sequence)
+{
+    assert(encoder != nullptr);
+
+    // Sequence numbers are compared by their distance, so they can wrap
+    if (static_cast<int32_t>(sequence - encoder->m_start) <= 0)
+        return;
+
+    uint32_t retired = std::min(sequence - encoder->m_start,
+                                encoder->m_end - encoder->m_start);
+
+    encoder->m_start += retired;
+    encoder->m_first_slot =
+        (encoder->m_first_slot + retired) % encoder->m_capacity;
+
+    if (static_cast<int32_t>(encoder->m_next_systematic -
+                             encoder->m_start) < 0)
+    {
+        encoder->m_next_systematic = encoder->m_start;
+    }
+}
+
+uint32_t krlnc_sliding_window_encoder_window_start(
+    krlnc_sliding_window_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return encoder->m_start;
+}
+
+uint32_t krlnc_sliding_window_encoder_window_end(
+    krlnc_sliding_window_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return encoder->m_end;
+}
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+uint32_t krlnc_sliding_window_encoder_max_payload_size(
+    krlnc_sliding_window_encoder_t encoder)
+{
+    assert(encoder != nullptr);
+    return sliding_window_max_payload_size(
+        encoder->m_capacity, encoder->m_symbol_size);
+}
+
+uint32_t krlnc_sliding_window_encoder_produce_payload(
+    krlnc_sliding_window_encoder_t encoder, uint8_t* payload)
+{
+    assert(encoder != nullptr);
+    assert(payload != nullptr);
+
+    uint32_t size = encoder->m_end - encoder->m_start;
+    if (size == 0)
+        return 0;
+
+    uint8_t* coefficients = payload + sliding_window_bounds_size;
+    uint32_t symbol_size = encoder->m_symbol_size;
+
+    if (encoder->m_systematic && encoder->m_next_systematic != encoder->m_end)
+    {
+        uint32_t sequence = encoder->m_next_systematic++;
+        uint32_t offset = sequence - encoder->m_start;
+
+        write_uint32(payload, sequence);
+        write_uint32(payload + sizeof(uint32_t), 1);
+        coefficients[0] = 1;
+        std::memcpy(coefficients + 1, window_symbol(encoder, offset),
+                    symbol_size);
+
+        return sliding_window_bounds_size + 1 + symbol_size;
+    }
+
+    write_uint32(payload, encoder->m_start);
+    write_uint32(payload + sizeof(uint32_t), size);
+
+    uint8_t* symbol = coefficients + size;
+    std::memset(symbol, 0, symbol_size);
+
+    const elimination& field = encoder->m_field;
+    for (uint32_t offset = 0; offset < size; ++offset)
+    {
+        coefficients[offset] = static_cast<uint8_t>(encoder->m_random());
+        field.multiply_add(symbol, window_symbol(encoder, offset),
+                           coefficients[offset], symbol_size);
+    }
+
+    return sliding_window_bounds_size + size + symbol_size;
+}
@@ -0,0 +1,149 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//------------------------------------------------------------------
+// KODO-RLNC-C TYPES
+//------------------------------------------------------------------
+
+/// Opaque pointer used for sliding window encoder
+typedef struct krlnc_sliding_window_encoder*
+    krlnc_sliding_window_encoder_t;
+
+//------------------------------------------------------------------
+// SLIDING WINDOW ENCODER BASIC API
+//------------------------------------------------------------------
+
+/// Create a new sliding window encoder object. Instead of coding a fixed
+/// generation, a sliding window encoder codes over a window of the most
+/// recent symbols. Symbols are pushed at the end of the window as they
+/// become available, and retired from the start of the window when the
+/// decoder has acknowledged them. Every symbol has a sequence number,
+/// which starts at 0 and increases by one for every pushed symbol.
+///
+/// Sliding window coding uses the binary8 field, and its payloads can only
+/// be consumed by a sliding window decoder with the same capacity.
+/// @param capacity The maximum number of symbols in the window
+/// @param symbol_size The size of a symbol in bytes
+/// @return Pointer to a new sliding window encoder instance.
+KODO_RLNC_API
+krlnc_sliding_window_encoder_t krlnc_create_sliding_window_encoder(
+    uint32_t capacity, uint32_t symbol_size);
+
+/// Deallocate and release the memory consumed by a sliding window encoder
+/// @param encoder The sliding window encoder which should be deallocated
+KODO_RLNC_API
+void krlnc_delete_sliding_window_encoder(
+    krlnc_sliding_window_encoder_t encoder);
+
+/// Return the maximum number of symbols in the window.
+/// @param encoder The sliding window encoder to query
+/// @return The capacity of the window
+KODO_RLNC_API
+uint32_t krlnc_sliding_window_encoder_capacity(
+    krlnc_sliding_window_encoder_t encoder);
+
+/// Return the symbol size of the encoder.
+/// @param encoder The sliding window encoder to query
+/// @return The size of a symbol in bytes
+KODO_RLNC_API
+uint32_t krlnc_sliding_window_encoder_symbol_size(
+    krlnc_sliding_window_encoder_t encoder);
+
+/// Switch the systematic encoding on. Every pushed symbol is then sent
+/// once uncoded before coded payloads are produced. This is the default.
+/// @param encoder The sliding window encoder
+KODO_RLNC_API
+void krlnc_sliding_window_encoder_set_systematic_on(
+    krlnc_sliding_window_encoder_t encoder);
+
+/// Switch the systematic encoding off
+/// @param encoder The sliding window encoder
+KODO_RLNC_API
+void krlnc_sliding_window_encoder_set_systematic_off(
+    krlnc_sliding_window_encoder_t encoder);
+
+/// Set the seed of the coefficient generator.
+/// @param encoder The sliding window encoder
+/// @param seed_value The seed value for the generator.
+KODO_RLNC_API
+void krlnc_sliding_window_encoder_set_seed(
+    krlnc_sliding_window_encoder_t encoder, uint32_t seed_value);
+
+//------------------------------------------------------------------
+// WINDOW API
+//------------------------------------------------------------------
+
+/// Push a symbol at the end of the window. The symbol is copied into the
+/// encoder, and it gets the sequence number returned by
+/// krlnc_sliding_window_encoder_window_end() before the call.
+/// @param encoder The sliding window encoder to use
+/// @param symbol The symbol data, which must have the symbol size
+/// @return Non-zero if the symbol was pushed, or 0 if the window is full
+KODO_RLNC_API
+uint8_t krlnc_sliding_window_encoder_push_symbol(
+    krlnc_sliding_window_encoder_t encoder, const uint8_t* symbol);
+
+/// Retire all symbols with a sequence number before the given one, which
+/// is typically the first symbol that the decoder has not acknowledged.
+/// The retired symbols are no longer included in the payloads.
+/// @param encoder The sliding window encoder to use
+/// @param sequence The sequence number of the first symbol to keep
+KODO_RLNC_API
+void krlnc_sliding_window_encoder_retire_symbols(
+    krlnc_sliding_window_encoder_t encoder, uint32_t sequence);
+
+/// Return the sequence number of the first symbol in the window.
+/// @param encoder The sliding window encoder to query
+/// @return The sequence number of the first symbol
+KODO_RLNC_API
+uint32_t krlnc_sliding_window_encoder_window_start(
+    krlnc_sliding_window_encoder_t encoder);
+
+/// Return the sequence number after the last symbol in the window, which
+/// is the sequence number of the next pushed symbol.
+/// @param encoder The sliding window encoder to query
+/// @return The sequence number after the last symbol
+KODO_RLNC_API
+uint32_t krlnc_sliding_window_encoder_window_end(
+    krlnc_sliding_window_encoder_t encoder);
+
+//------------------------------------------------------------------
+// PAYLOAD API
+//------------------------------------------------------------------
+
+/// Return the maximum possible payload size of a sliding window encoder,
+/// which includes the window bounds and one coefficient for every symbol
+/// in a full window.
+/// @param encoder The sliding window encoder to query.
+/// @return The payload size in bytes
+KODO_RLNC_API
+uint32_t krlnc_sliding_window_encoder_max_payload_size(
+    krlnc_sliding_window_encoder_t encoder);
+
+/// Produce a payload in the provided buffer. With systematic encoding,
+/// the payload contains the first symbol that has not been sent yet, and
+/// otherwise a random combination of all symbols in the window. The
+/// payload header contains the bounds of the window that was coded.
+/// @param encoder The sliding window encoder to use.
+/// @param payload The buffer which should contain the payload.
+/// @return The total bytes used from the payload buffer, or 0 if the
+///         window is empty
+KODO_RLNC_API
+uint32_t krlnc_sliding_window_encoder_produce_payload(
+    krlnc_sliding_window_encoder_t encoder, uint8_t* payload);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,282 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <kodo_rlnc_c/block_encoder.h>
+#include <kodo_rlnc_c/block_decoder.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+static void test_block_coders(uint32_t symbols, uint32_t symbol_size,
+                              uint64_t size)
+{
+    auto encoder = krlnc_create_block_encoder(
+        krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_block_decoder(
+        krlnc_binary8, symbols, symbol_size);
+
+    std::vector<uint8_t> data_in(size);
+    std::generate(data_in.begin(), data_in.end(), rand);
+    std::vector<uint8_t> data_out(size);
+
+    krlnc_block_encoder_set_data(encoder, data_in.data(), size);
+    krlnc_block_decoder_set_data(decoder, data_out.data(), size);
+
+    uint64_t block_size = symbols * symbol_size;
+    uint32_t generations = (uint32_t)((size + block_size - 1) / block_size);
+    EXPECT_EQ(generations, krlnc_block_encoder_generations(encoder));
+    EXPECT_EQ(generations, krlnc_block_decoder_generations(decoder));
+    EXPECT_EQ(krlnc_block_encoder_max_payload_size(encoder),
+              krlnc_block_decoder_max_payload_size(decoder));
+
+    std::vector<uint8_t> payload(
+        krlnc_block_encoder_max_payload_size(encoder));
+
+    // Send the generations in reverse order and drop every third payload
+    uint32_t sent = 0;
+    for (uint32_t g = generations; g-- > 0;)
+    {
+        krlnc_block_encoder_set_generation(encoder, g);
+        EXPECT_EQ(g, krlnc_block_encoder_generation(encoder));
+
+        while (!krlnc_block_decoder_is_generation_complete(decoder, g))
+        {
+            uint32_t bytes_used =
+                krlnc_block_encoder_produce_payload(encoder, payload.data());
+            EXPECT_LE(bytes_used, payload.size());
+
+            if (++sent % 3 == 0)
+                continue;
+
+            krlnc_block_decoder_consume_payload(
+                decoder, payload.data(), bytes_used);
+        }
+        EXPECT_EQ(generations - g,
+                  krlnc_block_decoder_generations_complete(decoder));
+    }
+
+    EXPECT_TRUE(krlnc_block_decoder_is_complete(decoder));
+    EXPECT_EQ(data_in, data_out);
+
+    krlnc_delete_block_encoder(encoder);
+    krlnc_delete_block_decoder(decoder);
+}
+
+TEST(test_block_coders, full_generations)
+{
+    test_block_coders(16, 100, 16 * 100 * 4);
+}
+
+TEST(test_block_coders, partial_last_generation)
+{
+    test_block_coders(16, 100, 16 * 100 * 3 + 250);
+    test_block_coders(16, 100, 16 * 100 + 1);
+    test_block_coders(16, 100, 99);
+}
+
+TEST(test_block_coders, many_generations)
+{
+    // More than 128 generations require a two byte generation id
+    test_block_coders(4, 10, 4 * 10 * 300 + 7);
+}
+
+TEST(test_block_coders, interleaved_generations)
+{
+    uint32_t symbols = 8;
+    uint32_t symbol_size = 64;
+    uint64_t size = symbols * symbol_size * 2 + 100;
+
+    auto encoder1 = krlnc_create_block_encoder(
+        krlnc_binary8, symbols, symbol_size);
+    auto encoder2 = krlnc_create_block_encoder(
+        krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_block_decoder(
+        krlnc_binary8, symbols, symbol_size);
+
+    krlnc_block_encoder_set_systematic_off(encoder1);
+    krlnc_block_encoder_set_coding_vector_format(encoder2, krlnc_seed);
+
+    std::vector<uint8_t> data_in(size);
+    std::generate(data_in.begin(), data_in.end(), rand);
+    std::vector<uint8_t> data_out(size);
+
+    krlnc_block_encoder_set_data(encoder1, data_in.data(), size);
+    krlnc_block_encoder_set_data(encoder2, data_in.data(), size);
+    krlnc_block_decoder_set_data(decoder, data_out.data(), size);
+
+    krlnc_block_encoder_set_generation(encoder2, 2);
+
+    std::vector<uint8_t> payload(
+        krlnc_block_encoder_max_payload_size(encoder1));
+
+    while (!krlnc_block_decoder_is_complete(decoder))
+    {
+        uint32_t bytes_used =
+            krlnc_block_encoder_produce_payload(encoder1, payload.data());
+        krlnc_block_decoder_consume_payload(
+            decoder, payload.data(), bytes_used);
+
+        bytes_used =
+            krlnc_block_encoder_produce_payload(encoder2, payload.data());
+        krlnc_block_decoder_consume_payload(
+            decoder, payload.data(), bytes_used);
+
+        if (krlnc_block_encoder_generation(encoder1) == 0 &&
+            krlnc_block_decoder_is_generation_complete(decoder, 0))
+        {
+            krlnc_block_encoder_set_generation(encoder1, 1);
+        }
+    }
+
+    EXPECT_EQ(data_in, data_out);
+
+    krlnc_delete_block_encoder(encoder1);
+    krlnc_delete_block_encoder(encoder2);
+    krlnc_delete_block_decoder(decoder);
+}
+
+TEST(test_block_coders, invalid_payloads)
+{
+    uint32_t symbols = 4;
+    uint32_t symbol_size = 16;
+    uint64_t size = symbols * symbol_size * 200;
+
+    auto encoder = krlnc_create_block_encoder(
+        krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_block_decoder(
+        krlnc_binary8, symbols, symbol_size);
+
+    std::vector<uint8_t> data_in(size);
+    std::generate(data_in.begin(), data_in.end(), rand);
+    std::vector<uint8_t> data_out(size);
+
+    EXPECT_NE(0U, krlnc_block_encoder_set_data(encoder, data_in.data(), size));
+    EXPECT_NE(0U, krlnc_block_decoder_set_data(decoder, data_out.data(), size));
+
+    // Data that has more generations than a 32-bit id can count is rejected
+    uint64_t too_large = (uint64_t(1) << 32) * symbols * symbol_size;
+    EXPECT_EQ(0U, krlnc_block_encoder_set_data(
+        encoder, data_in.data(), too_large));
+    EXPECT_EQ(0U, krlnc_block_decoder_set_data(
+        decoder, data_out.data(), too_large));
+    EXPECT_EQ(200U, krlnc_block_encoder_generations(encoder));
+    EXPECT_EQ(200U, krlnc_block_decoder_generations(decoder));
+
+    std::vector<uint8_t> payload(
+        krlnc_block_encoder_max_payload_size(encoder));
+
+    // Generation ids that do not end within the payload, that overflow
+    // 32 bits or that are out of range are ignored
+    uint8_t truncated[] = { 0x80, 0x80 };
+    krlnc_block_decoder_consume_payload(decoder, truncated, 2);
+    uint8_t overflow[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0x00 };
+    krlnc_block_decoder_consume_payload(decoder, overflow, 6);
+    uint8_t out_of_range[] = { 0xFF, 0x7F, 0x00 };
+    krlnc_block_decoder_consume_payload(decoder, out_of_range, 3);
+    EXPECT_EQ(0U, krlnc_block_decoder_active_generations(decoder));
+    EXPECT_EQ(0U, krlnc_block_decoder_dropped_payloads(decoder));
+
+    // Only a limited number of generations are decoded at the same time
+    krlnc_block_decoder_set_max_active_generations(decoder, 3);
+    EXPECT_EQ(3U, krlnc_block_decoder_max_active_generations(decoder));
+
+    for (uint32_t g = 0; g < 5; ++g)
+    {
+        krlnc_block_encoder_set_generation(encoder, g);
+        uint32_t bytes_used =
+            krlnc_block_encoder_produce_payload(encoder, payload.data());
+        krlnc_block_decoder_consume_payload(
+            decoder, payload.data(), bytes_used);
+    }
+    EXPECT_EQ(3U, krlnc_block_decoder_active_generations(decoder));
+    EXPECT_EQ(2U, krlnc_block_decoder_dropped_payloads(decoder));
+
+    // Completing a generation makes room for another one
+    krlnc_block_encoder_set_generation(encoder, 0);
+    while (!krlnc_block_decoder_is_generation_complete(decoder, 0))
+    {
+        uint32_t bytes_used =
+            krlnc_block_encoder_produce_payload(encoder, payload.data());
+        krlnc_block_decoder_consume_payload(
+            decoder, payload.data(), bytes_used);
+    }
+    EXPECT_EQ(2U, krlnc_block_decoder_active_generations(decoder));
+
+    krlnc_block_encoder_set_generation(encoder, 4);
+    uint32_t bytes_used =
+        krlnc_block_encoder_produce_payload(encoder, payload.data());
+    krlnc_block_decoder_consume_payload(decoder, payload.data(), bytes_used);
+    EXPECT_EQ(3U, krlnc_block_decoder_active_generations(decoder));
+
+    krlnc_delete_block_encoder(encoder);
+    krlnc_delete_block_decoder(decoder);
+}
+
+#if !defined(_WIN32)
+TEST(test_block_coders, file_storage)
+{
+    uint32_t symbols = 8;
+    uint32_t symbol_size = 64;
+    uint64_t size = symbols * symbol_size * 3 + 100;
+
+    const char* input = "test_block_coders_input.bin";
+    const char* output = "test_block_coders_output.bin";
+
+    std::vector<uint8_t> data_in(size);
+    std::generate(data_in.begin(), data_in.end(), rand);
+
+    FILE* file = fopen(input, "wb");
+    ASSERT_NE(nullptr, file);
+    EXPECT_EQ(size, fwrite(data_in.data(), 1, size, file));
+    fclose(file);
+
+    auto encoder = krlnc_create_block_encoder(
+        krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_block_decoder(
+        krlnc_binary8, symbols, symbol_size);
+
+    EXPECT_FALSE(krlnc_block_encoder_set_file(encoder, "does/not/exist"));
+    EXPECT_TRUE(krlnc_block_encoder_set_file(encoder, input));
+    EXPECT_TRUE(krlnc_block_decoder_set_file(decoder, output, size));
+    EXPECT_EQ(4U, krlnc_block_encoder_generations(encoder));
+    EXPECT_EQ(4U, krlnc_block_decoder_generations(decoder));
+
+    std::vector<uint8_t> payload(
+        krlnc_block_encoder_max_payload_size(encoder));
+
+    for (uint32_t i = 0; i < krlnc_block_encoder_generations(encoder); ++i)
+    {
+        krlnc_block_encoder_set_generation(encoder, i);
+
+        while (!krlnc_block_decoder_is_generation_complete(decoder, i))
+        {
+            uint32_t bytes_used =
+                krlnc_block_encoder_produce_payload(encoder, payload.data());
+            krlnc_block_decoder_consume_payload(
+                decoder, payload.data(), bytes_used);
+        }
+    }
+    EXPECT_TRUE(krlnc_block_decoder_is_complete(decoder));
+
+    // Deleting the decoder unmaps the file
+    krlnc_delete_block_encoder(encoder);
+    krlnc_delete_block_decoder(decoder);
+
+    std::vector<uint8_t> data_out(size + 1);
+    file = fopen(output, "rb");
+    ASSERT_NE(nullptr, file);
+    EXPECT_EQ(size, fread(data_out.data(), 1, data_out.size(), file));
+    fclose(file);
+
+    data_out.resize(size);
+    EXPECT_EQ(data_in, data_out);
+
+    std::remove(input);
+    std::remove(output);
+}
+#endif
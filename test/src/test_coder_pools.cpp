@@ -0,0 +1,172 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <kodo_rlnc_c/encoder_pool.h>
+#include <kodo_rlnc_c/decoder_pool.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(test_coder_pools, acquire_release)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 100;
+
+    auto encoder_pool = krlnc_create_encoder_pool(
+        krlnc_binary8, symbols, symbol_size, 2);
+    auto decoder_pool = krlnc_create_decoder_pool(
+        krlnc_binary8, symbols, symbol_size, 2);
+
+    EXPECT_EQ(2U, krlnc_encoder_pool_available(encoder_pool));
+    EXPECT_EQ(2U, krlnc_decoder_pool_available(decoder_pool));
+
+    std::vector<uint8_t> data_in(symbols * symbol_size);
+    std::vector<uint8_t> data_out(symbols * symbol_size);
+
+    // Decode several generations with recycled coders
+    for (uint32_t generation = 0; generation < 4; ++generation)
+    {
+        krlnc_encoder_t encoder = krlnc_encoder_pool_acquire(encoder_pool);
+        krlnc_decoder_t decoder = krlnc_decoder_pool_acquire(decoder_pool);
+
+        EXPECT_EQ(1U, krlnc_encoder_pool_available(encoder_pool));
+        EXPECT_EQ(1U, krlnc_decoder_pool_available(decoder_pool));
+
+        EXPECT_EQ(0U, krlnc_encoder_rank(encoder));
+        EXPECT_EQ(0U, krlnc_decoder_rank(decoder));
+
+        std::generate(data_in.begin(), data_in.end(), rand);
+        krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+        krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+        std::vector<uint8_t> payload(krlnc_encoder_max_payload_size(encoder));
+        while (!krlnc_decoder_is_complete(decoder))
+        {
+            krlnc_encoder_produce_payload(encoder, payload.data());
+            krlnc_decoder_consume_payload(decoder, payload.data());
+        }
+        EXPECT_EQ(data_in, data_out);
+
+        krlnc_encoder_pool_release(encoder_pool, encoder);
+        krlnc_decoder_pool_release(decoder_pool, decoder);
+
+        EXPECT_EQ(2U, krlnc_encoder_pool_available(encoder_pool));
+        EXPECT_EQ(2U, krlnc_decoder_pool_available(decoder_pool));
+    }
+
+    krlnc_delete_encoder_pool(encoder_pool);
+    krlnc_delete_decoder_pool(decoder_pool);
+}
+
+TEST(test_coder_pools, grow)
+{
+    auto pool = krlnc_create_decoder_pool(krlnc_binary, 8, 10, 0);
+    EXPECT_EQ(0U, krlnc_decoder_pool_available(pool));
+
+    std::vector<krlnc_decoder_t> decoders;
+    for (uint32_t i = 0; i < 3; ++i)
+        decoders.push_back(krlnc_decoder_pool_acquire(pool));
+
+    EXPECT_EQ(0U, krlnc_decoder_pool_available(pool));
+
+    for (auto decoder : decoders)
+        krlnc_decoder_pool_release(pool, decoder);
+
+    EXPECT_EQ(3U, krlnc_decoder_pool_available(pool));
+
+    krlnc_delete_decoder_pool(pool);
+}
+
+static void on_symbol_decoded(uint32_t, const uint8_t*, void* context)
+{
+    ++*static_cast<uint32_t*>(context);
+}
+
+TEST(test_coder_pools, release_restores_defaults)
+{
+    uint32_t symbols = 8;
+    uint32_t symbol_size = 100000;
+
+    auto encoder_pool = krlnc_create_encoder_pool(
+        krlnc_binary8, symbols, symbol_size, 1);
+    auto decoder_pool = krlnc_create_decoder_pool(
+        krlnc_binary8, symbols, symbol_size, 1);
+
+    // The first user changes the configuration
+    krlnc_encoder_t encoder = krlnc_encoder_pool_acquire(encoder_pool);
+    krlnc_decoder_t decoder = krlnc_decoder_pool_acquire(decoder_pool);
+
+    uint8_t systematic = krlnc_encoder_is_systematic_on(encoder);
+    float density = krlnc_encoder_density(encoder);
+    uint8_t status_updater = krlnc_decoder_is_status_updater_enabled(decoder);
+
+    uint32_t reported = 0;
+    std::vector<uint8_t> data(symbols * symbol_size);
+    std::vector<uint8_t> data_out(symbols * symbol_size);
+    krlnc_encoder_set_symbols_storage(encoder, data.data());
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+    krlnc_encoder_set_systematic_off(encoder);
+    krlnc_encoder_set_density(encoder, density / 2);
+    krlnc_encoder_set_seed(encoder, 42);
+    krlnc_encoder_set_column_threads(encoder, 2);
+    krlnc_encoder_set_reconfigure_cache(encoder, 2);
+    krlnc_encoder_set_timing_on(encoder);
+    krlnc_decoder_set_symbol_decoded_callback(
+        decoder, on_symbol_decoded, &reported);
+    krlnc_decoder_set_column_threads(decoder, 2);
+    krlnc_decoder_set_reconfigure_cache(decoder, 2);
+    if (status_updater)
+        krlnc_decoder_set_status_updater_off(decoder);
+    else
+        krlnc_decoder_set_status_updater_on(decoder);
+
+    std::vector<uint8_t> symbol(symbol_size);
+    krlnc_encoder_produce_systematic_symbol(encoder, symbol.data(), 0);
+    krlnc_decoder_consume_systematic_symbol(decoder, symbol.data(), 0);
+    EXPECT_EQ(1U, reported);
+
+    krlnc_encoder_pool_release(encoder_pool, encoder);
+    krlnc_decoder_pool_release(decoder_pool, decoder);
+
+    // The next user gets the configuration of a new coder
+    encoder = krlnc_encoder_pool_acquire(encoder_pool);
+    decoder = krlnc_decoder_pool_acquire(decoder_pool);
+
+    EXPECT_EQ(systematic, krlnc_encoder_is_systematic_on(encoder));
+    EXPECT_EQ(density, krlnc_encoder_density(encoder));
+    EXPECT_EQ(1U, krlnc_encoder_column_threads(encoder));
+    EXPECT_EQ(0U, krlnc_encoder_reconfigure_cache(encoder));
+    EXPECT_EQ(status_updater,
+              krlnc_decoder_is_status_updater_enabled(decoder));
+    EXPECT_EQ(1U, krlnc_decoder_column_threads(decoder));
+    EXPECT_EQ(0U, krlnc_decoder_reconfigure_cache(decoder));
+
+    krlnc_encoder_stats encoder_stats;
+    krlnc_encoder_get_stats(encoder, &encoder_stats);
+    EXPECT_EQ(0U, encoder_stats.payloads_produced);
+
+    krlnc_decoder_stats decoder_stats;
+    krlnc_decoder_get_stats(decoder, &decoder_stats);
+    EXPECT_EQ(0U, decoder_stats.payloads_consumed);
+
+    // The callback of the previous user is not invoked
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+    krlnc_decoder_consume_systematic_symbol(decoder, symbol.data(), 0);
+    EXPECT_EQ(1U, reported);
+
+    // A coder that was reconfigured is deleted instead of being kept
+    krlnc_encoder_reconfigure(encoder, symbols * 2, symbol_size);
+    krlnc_decoder_reconfigure(decoder, symbols, symbol_size / 2);
+    krlnc_encoder_pool_release(encoder_pool, encoder);
+    krlnc_decoder_pool_release(decoder_pool, decoder);
+
+    EXPECT_EQ(0U, krlnc_encoder_pool_available(encoder_pool));
+    EXPECT_EQ(0U, krlnc_decoder_pool_available(decoder_pool));
+
+    krlnc_delete_encoder_pool(encoder_pool);
+    krlnc_delete_decoder_pool(decoder_pool);
+}
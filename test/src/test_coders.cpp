@@ -7,6 +7,7 @@
 #include <kodo_rlnc_c/decoder.h>
 
 #include <algorithm>
+#include <cstdio>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -172,3 +173,1112 @@ TEST(test_coders, symbol_status_api)
 
     krlnc_delete_decoder(decoder);
 }
+
+TEST(test_coders, produce_payloads)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    uint32_t count = symbols + 4;
+    uint32_t stride = krlnc_encoder_max_payload_size(encoder);
+    std::vector<uint8_t> payloads(count * stride);
+    std::vector<uint32_t> sizes(count);
+
+    uint32_t total_bytes = krlnc_encoder_produce_payloads(
+        encoder, payloads.data(), count, stride, sizes.data());
+
+    uint32_t expected_bytes = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        EXPECT_GT(sizes[i], 0U);
+        EXPECT_LE(sizes[i], stride);
+        expected_bytes += sizes[i];
+    }
+    EXPECT_EQ(expected_bytes, total_bytes);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        krlnc_decoder_consume_payload(decoder, payloads.data() + i * stride);
+    }
+    EXPECT_TRUE(krlnc_decoder_is_complete(decoder));
+    EXPECT_EQ(data_in, data_out);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+}
+
+static void test_produce_segmented_payloads(
+    int32_t field, bool systematic, uint32_t symbol_size)
+{
+    uint32_t symbols = 16;
+
+    auto encoder = krlnc_create_encoder(field, symbols, symbol_size);
+    auto decoder = krlnc_create_decoder(field, symbols, symbol_size);
+
+    if (!systematic)
+        krlnc_encoder_set_systematic_off(encoder);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    // The systematic symbols and the first coded payloads share a batch
+    uint32_t count = 12;
+    uint32_t stride = krlnc_encoder_max_segmented_payload_size(encoder);
+    std::vector<uint8_t> payloads(count * stride);
+    std::vector<uint32_t> sizes(count);
+
+    uint32_t batches = 0;
+    while (!krlnc_decoder_is_complete(decoder))
+    {
+        ASSERT_LT(batches++, 10U);
+
+        uint32_t total_bytes = krlnc_encoder_produce_segmented_payloads(
+            encoder, payloads.data(), count, stride, sizes.data());
+
+        uint32_t expected_bytes = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            EXPECT_GT(sizes[i], 0U);
+            EXPECT_LE(sizes[i], stride);
+            expected_bytes += sizes[i];
+
+            krlnc_decoder_consume_segmented_payload(
+                decoder, payloads.data() + i * stride, sizes[i]);
+        }
+        EXPECT_EQ(expected_bytes, total_bytes);
+    }
+    EXPECT_EQ(data_in, data_out);
+
+    krlnc_encoder_stats stats;
+    krlnc_encoder_get_stats(encoder, &stats);
+    EXPECT_EQ(batches * count, stats.payloads_produced);
+    EXPECT_EQ(stats.coded_payloads, stats.coefficients_generated);
+
+    krlnc_encoder_set_coding_vector_format(encoder, krlnc_seed);
+    EXPECT_EQ(0U, krlnc_encoder_produce_segmented_payloads(
+        encoder, payloads.data(), count, stride, NULL));
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+}
+
+TEST(test_coders, produce_segmented_payloads)
+{
+    // The binary8 symbols span several column blocks of the blocked pass
+    test_produce_segmented_payloads(krlnc_binary8, true, 100000);
+    test_produce_segmented_payloads(krlnc_binary8, false, 100000);
+    test_produce_segmented_payloads(krlnc_binary8, false, 160);
+
+    // The other fields produce one payload at a time
+    test_produce_segmented_payloads(krlnc_binary, false, 160);
+    test_produce_segmented_payloads(krlnc_binary16, true, 160);
+}
+
+TEST(test_coders, consume_payloads)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+    krlnc_encoder_set_systematic_off(encoder);
+
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    uint32_t count = symbols / 2;
+    uint32_t stride = krlnc_encoder_max_payload_size(encoder);
+    std::vector<uint8_t> payloads(count * stride);
+
+    while (!krlnc_decoder_is_complete(decoder))
+    {
+        krlnc_encoder_produce_payloads(
+            encoder, payloads.data(), count, stride, NULL);
+        krlnc_decoder_consume_payloads(
+            decoder, payloads.data(), count, stride);
+    }
+    EXPECT_EQ(symbols, krlnc_decoder_rank(decoder));
+    EXPECT_EQ(data_in, data_out);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+}
+
+TEST(test_coders, consume_payload_const)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto decoder1 = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+    auto decoder2 = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> data_out1(krlnc_decoder_block_size(decoder1));
+    krlnc_decoder_set_symbols_storage(decoder1, data_out1.data());
+    std::vector<uint8_t> data_out2(krlnc_decoder_block_size(decoder2));
+    krlnc_decoder_set_symbols_storage(decoder2, data_out2.data());
+
+    std::vector<uint8_t> payload(krlnc_encoder_max_payload_size(encoder));
+
+    // Both decoders consume the same payload buffer
+    while (!krlnc_decoder_is_complete(decoder2))
+    {
+        uint32_t bytes_used =
+            krlnc_encoder_produce_payload(encoder, payload.data());
+        std::vector<uint8_t> original = payload;
+
+        EXPECT_TRUE(krlnc_decoder_consume_payload_const(
+            decoder1, payload.data(), bytes_used) != 0);
+        EXPECT_EQ(original, payload);
+
+        EXPECT_TRUE(krlnc_decoder_consume_payload_const(
+            decoder2, payload.data(), bytes_used) != 0);
+        EXPECT_EQ(original, payload);
+    }
+    EXPECT_TRUE(krlnc_decoder_is_complete(decoder1));
+    EXPECT_EQ(data_in, data_out1);
+    EXPECT_EQ(data_in, data_out2);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder1);
+    krlnc_delete_decoder(decoder2);
+}
+
+static void test_payload_segments(bool systematic)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+
+    EXPECT_EQ(krlnc_encoder_max_segmented_payload_size(encoder),
+              krlnc_decoder_max_segmented_payload_size(decoder));
+
+    if (!systematic)
+        krlnc_encoder_set_systematic_off(encoder);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    std::vector<uint8_t> payload(
+        krlnc_decoder_max_segmented_payload_size(decoder));
+
+    uint32_t produced = 0;
+    while (!krlnc_decoder_is_complete(decoder))
+    {
+        // The systematic phase follows the segmented payloads
+        if (produced > 0)
+        {
+            EXPECT_EQ(systematic && produced < symbols,
+                      krlnc_encoder_in_systematic_phase(encoder) != 0);
+        }
+
+        krlnc_payload_segments segments;
+        uint32_t bytes_used =
+            krlnc_encoder_produce_payload_segments(encoder, &segments);
+
+        EXPECT_EQ(segments.header_size + segments.symbol_size, bytes_used);
+        EXPECT_LE(bytes_used, payload.size());
+        EXPECT_EQ(symbol_size, segments.symbol_size);
+
+        // Systematic symbols are taken directly from the symbol storage
+        if (systematic && produced < symbols)
+        {
+            EXPECT_EQ(data_in.data() + produced * symbol_size,
+                      segments.symbol);
+        }
+        ++produced;
+
+        // Gather the segments as the network stack would
+        std::copy_n(segments.header, segments.header_size, payload.begin());
+        std::copy_n(segments.symbol, segments.symbol_size,
+                    payload.begin() + segments.header_size);
+
+        krlnc_decoder_consume_segmented_payload(
+            decoder, payload.data(), bytes_used);
+    }
+    EXPECT_EQ(data_in, data_out);
+
+    if (systematic)
+    {
+        EXPECT_EQ(symbols, produced);
+    }
+
+    // Segmented payloads cannot carry a seed instead of the coefficients
+    krlnc_payload_segments segments;
+    krlnc_encoder_set_coding_vector_format(encoder, krlnc_seed);
+    EXPECT_EQ(0U, krlnc_encoder_produce_payload_segments(encoder, &segments));
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+}
+
+TEST(test_coders, payload_segments)
+{
+    test_payload_segments(true);
+    test_payload_segments(false);
+}
+
+#if !defined(_WIN32)
+TEST(test_coders, file_storage)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+    uint64_t offset = 1000;
+
+    const char* input = "test_coders_input.bin";
+    const char* output = "test_coders_output.bin";
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+
+    uint64_t block_size = krlnc_encoder_block_size(encoder);
+
+    // The symbols are stored after some other data in the input file
+    std::vector<uint8_t> file_in(offset + block_size);
+    std::generate(file_in.begin(), file_in.end(), rand);
+
+    FILE* file = fopen(input, "wb");
+    ASSERT_NE(nullptr, file);
+    EXPECT_EQ(file_in.size(), fwrite(file_in.data(), 1, file_in.size(), file));
+    fclose(file);
+
+    // The input file is too short for a block at a larger offset
+    EXPECT_FALSE(krlnc_encoder_set_file_storage(encoder, input, offset + 1));
+    EXPECT_TRUE(krlnc_encoder_set_file_storage(encoder, input, offset));
+
+    // The end of a block at a huge offset does not fit in a file position
+    uint64_t huge_offset = UINT64_MAX - block_size / 2;
+    EXPECT_FALSE(krlnc_encoder_set_file_storage(encoder, input, huge_offset));
+
+    std::remove(output);
+    EXPECT_FALSE(krlnc_decoder_set_file_storage(decoder, output, huge_offset));
+    EXPECT_EQ(nullptr, fopen(output, "rb"));
+    EXPECT_TRUE(krlnc_decoder_set_file_storage(decoder, output, offset));
+
+    std::vector<uint8_t> payload(krlnc_encoder_max_payload_size(encoder));
+
+    while (!krlnc_decoder_is_complete(decoder))
+    {
+        krlnc_encoder_produce_payload(encoder, payload.data());
+        krlnc_decoder_consume_payload(decoder, payload.data());
+    }
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+
+    // The output file is extended to hold the block at the offset
+    std::vector<uint8_t> file_out(offset + block_size + 1);
+    file = fopen(output, "rb");
+    ASSERT_NE(nullptr, file);
+    EXPECT_EQ(offset + block_size,
+              fread(file_out.data(), 1, file_out.size(), file));
+    fclose(file);
+
+    EXPECT_TRUE(std::equal(file_in.begin() + offset, file_in.end(),
+                           file_out.begin() + offset));
+
+    std::remove(input);
+    std::remove(output);
+}
+#endif
+
+TEST(test_coders, decoder_stats)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    krlnc_decoder_stats stats;
+    krlnc_decoder_get_stats(decoder, &stats);
+    EXPECT_EQ(0U, stats.payloads_consumed);
+
+    std::vector<uint8_t> payload(krlnc_encoder_max_payload_size(encoder));
+
+    uint64_t consumed = 0;
+    while (!krlnc_decoder_is_complete(decoder))
+    {
+        krlnc_encoder_produce_payload(encoder, payload.data());
+        krlnc_decoder_consume_payload(decoder, payload.data());
+        ++consumed;
+    }
+
+    // Any payload after the decoder is complete is linearly dependent
+    krlnc_encoder_produce_payload(encoder, payload.data());
+    krlnc_decoder_consume_payload(decoder, payload.data());
+    ++consumed;
+
+    krlnc_decoder_get_stats(decoder, &stats);
+    EXPECT_EQ(consumed, stats.payloads_consumed);
+    EXPECT_EQ(symbols, stats.innovative_payloads);
+    EXPECT_EQ(consumed - symbols, stats.linearly_dependent_payloads);
+    EXPECT_EQ(0U, stats.systematic_payloads);
+    EXPECT_EQ(0U, stats.coded_payloads);
+    EXPECT_EQ(consumed, stats.unclassified_payloads);
+
+    // The cost of unclassified payloads is not estimated
+    EXPECT_EQ(0U, stats.estimated_multiply_add_operations);
+    EXPECT_EQ(0U, stats.estimated_backward_substitution_operations);
+
+    // Symbols of a known type are classified
+    krlnc_reset_decoder(decoder);
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+    krlnc_decoder_reset_stats(decoder);
+
+    std::vector<uint8_t> coefficients(
+        krlnc_encoder_coefficient_vector_size(encoder));
+    std::vector<uint8_t> symbol(symbol_size);
+
+    krlnc_decoder_consume_systematic_symbol(decoder, data_in.data(), 0);
+
+    krlnc_encoder_generate(encoder, coefficients.data());
+    krlnc_encoder_produce_symbol(
+        encoder, symbol.data(), coefficients.data());
+    krlnc_decoder_consume_symbol(
+        decoder, symbol.data(), coefficients.data());
+
+    krlnc_decoder_get_stats(decoder, &stats);
+    EXPECT_EQ(2U, stats.payloads_consumed);
+    EXPECT_EQ(1U, stats.systematic_payloads);
+    EXPECT_EQ(1U, stats.coded_payloads);
+    EXPECT_EQ(0U, stats.unclassified_payloads);
+
+    // The coded symbol is reduced with the systematic symbol, and then
+    // substituted back into no partially decoded rows
+    EXPECT_EQ(1U, stats.estimated_multiply_add_operations);
+    EXPECT_EQ(0U, stats.estimated_backward_substitution_operations);
+
+    // A segment with the decoded systematic symbol 0 is a duplicate, which
+    // is counted as a linearly dependent systematic payload
+    krlnc_reset_encoder(encoder);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> segmented(
+        krlnc_decoder_max_segmented_payload_size(decoder));
+    krlnc_payload_segments segments;
+    uint32_t bytes_used =
+        krlnc_encoder_produce_payload_segments(encoder, &segments);
+
+    std::copy_n(segments.header, segments.header_size, segmented.begin());
+    std::copy_n(segments.symbol, segments.symbol_size,
+                segmented.begin() + segments.header_size);
+
+    uint32_t rank = krlnc_decoder_rank(decoder);
+    krlnc_decoder_consume_segmented_payload(
+        decoder, segmented.data(), bytes_used);
+    EXPECT_EQ(rank, krlnc_decoder_rank(decoder));
+
+    krlnc_decoder_get_stats(decoder, &stats);
+    EXPECT_EQ(3U, stats.payloads_consumed);
+    EXPECT_EQ(2U, stats.systematic_payloads);
+    EXPECT_EQ(2U, stats.innovative_payloads);
+    EXPECT_EQ(1U, stats.linearly_dependent_payloads);
+    EXPECT_EQ(1U, stats.estimated_multiply_add_operations);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+}
+
+TEST(test_coders, encoder_stats)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> payload(krlnc_encoder_max_payload_size(encoder));
+
+    krlnc_encoder_stats stats;
+    krlnc_encoder_get_stats(encoder, &stats);
+    EXPECT_EQ(0U, stats.payloads_produced);
+
+    // The systematic phase is followed by coded payloads
+    uint32_t coded = 4;
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < symbols + coded; ++i)
+        bytes += krlnc_encoder_produce_payload(encoder, payload.data());
+
+    krlnc_encoder_get_stats(encoder, &stats);
+    EXPECT_EQ(symbols + coded, stats.payloads_produced);
+    EXPECT_EQ(symbols, stats.systematic_payloads);
+    EXPECT_EQ(coded, stats.coded_payloads);
+    EXPECT_EQ(bytes, stats.bytes_produced);
+    EXPECT_EQ(coded, stats.coefficients_generated);
+    EXPECT_EQ(0U, stats.timed_calls);
+
+    // Produce symbols with timing switched on
+    krlnc_encoder_reset_stats(encoder);
+    krlnc_encoder_set_timing_on(encoder);
+
+    std::vector<uint8_t> coefficients(
+        krlnc_encoder_coefficient_vector_size(encoder));
+    std::vector<uint8_t> symbol(symbol_size);
+
+    krlnc_encoder_generate(encoder, coefficients.data());
+    krlnc_encoder_produce_symbol(encoder, symbol.data(), coefficients.data());
+    krlnc_encoder_produce_systematic_symbol(encoder, symbol.data(), 0);
+
+    krlnc_encoder_get_stats(encoder, &stats);
+    EXPECT_EQ(2U, stats.payloads_produced);
+    EXPECT_EQ(1U, stats.systematic_payloads);
+    EXPECT_EQ(1U, stats.coded_payloads);
+    EXPECT_EQ(2U * symbol_size, stats.bytes_produced);
+    EXPECT_EQ(1U, stats.coefficients_generated);
+    EXPECT_EQ(2U, stats.timed_calls);
+
+    krlnc_encoder_set_timing_off(encoder);
+    krlnc_encoder_produce_payload(encoder, payload.data());
+
+    krlnc_encoder_get_stats(encoder, &stats);
+    EXPECT_EQ(3U, stats.payloads_produced);
+    EXPECT_EQ(2U, stats.timed_calls);
+
+    krlnc_delete_encoder(encoder);
+}
+
+TEST(test_coders, consume_payload_with_status)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    std::vector<uint8_t> payload(krlnc_encoder_max_payload_size(encoder));
+
+    // Every systematic payload decodes exactly one symbol
+    krlnc_decoder_consume_status status;
+    uint32_t decoded = 0;
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        krlnc_encoder_produce_payload(encoder, payload.data());
+        krlnc_decoder_consume_payload_with_status(
+            decoder, payload.data(), &status);
+
+        EXPECT_TRUE(status.innovative);
+        EXPECT_EQ(i + 1, status.rank);
+        EXPECT_EQ(krlnc_decoder_rank(decoder), status.rank);
+        EXPECT_EQ(krlnc_decoder_is_complete(decoder), status.complete);
+        decoded += status.symbols_decoded;
+    }
+
+    EXPECT_TRUE(status.complete);
+    EXPECT_EQ(symbols, decoded);
+    EXPECT_EQ(data_in, data_out);
+
+    // A payload after completion is not innovative
+    krlnc_encoder_produce_payload(encoder, payload.data());
+    krlnc_decoder_consume_payload_with_status(
+        decoder, payload.data(), &status);
+
+    EXPECT_FALSE(status.innovative);
+    EXPECT_TRUE(status.complete);
+    EXPECT_EQ(symbols, status.rank);
+    EXPECT_EQ(0U, status.symbols_decoded);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+}
+
+TEST(test_coders, symbol_status_bitmaps)
+{
+    uint32_t symbols = 70;
+    uint32_t symbol_size = 40;
+    krlnc_decoder_t decoder = krlnc_create_decoder(
+        krlnc_binary8, symbols, symbol_size);
+
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder), '\0');
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    uint32_t words = krlnc_decoder_symbol_status_bitmap_words(decoder);
+    EXPECT_EQ(2U, words);
+
+    std::vector<uint8_t> symbol(krlnc_decoder_symbol_size(decoder));
+    std::vector<uint8_t> coefficients(
+        krlnc_decoder_coefficient_vector_size(decoder), 0);
+
+    krlnc_decoder_consume_systematic_symbol(decoder, symbol.data(), 0);
+    krlnc_decoder_consume_systematic_symbol(decoder, symbol.data(), 65);
+
+    // A coded symbol that combines two symbols is partially decoded
+    coefficients[3] = 1;
+    coefficients[4] = 1;
+    krlnc_decoder_consume_symbol(decoder, symbol.data(), coefficients.data());
+
+    std::vector<uint64_t> missing(words);
+    std::vector<uint64_t> partially_decoded(words);
+    std::vector<uint64_t> decoded(words);
+    std::vector<uint64_t> pivot(words);
+
+    krlnc_decoder_symbol_status_bitmaps(
+        decoder, missing.data(), partially_decoded.data(), decoded.data(),
+        pivot.data());
+
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        uint64_t bit = uint64_t(1) << (i % 64);
+        SCOPED_TRACE(i);
+
+        EXPECT_EQ(krlnc_decoder_is_symbol_missing(decoder, i) != 0,
+                  (missing[i / 64] & bit) != 0);
+        EXPECT_EQ(krlnc_decoder_is_symbol_partially_decoded(decoder, i) != 0,
+                  (partially_decoded[i / 64] & bit) != 0);
+        EXPECT_EQ(krlnc_decoder_is_symbol_decoded(decoder, i) != 0,
+                  (decoded[i / 64] & bit) != 0);
+        EXPECT_EQ(krlnc_decoder_is_symbol_pivot(decoder, i) != 0,
+                  (pivot[i / 64] & bit) != 0);
+    }
+
+    EXPECT_EQ(uint64_t(1), decoded[0]);
+    EXPECT_EQ(uint64_t(1) << 1, decoded[1]);
+
+    // The bits after the last symbol are cleared
+    EXPECT_EQ(0U, missing[1] >> (symbols - 64));
+
+    // The bitmaps are optional
+    std::vector<uint64_t> decoded_only(words);
+    krlnc_decoder_symbol_status_bitmaps(
+        decoder, nullptr, nullptr, decoded_only.data(), nullptr);
+    EXPECT_EQ(decoded, decoded_only);
+
+    krlnc_delete_decoder(decoder);
+}
+
+struct decoded_symbols
+{
+    std::vector<uint32_t> indices;
+    std::vector<const uint8_t*> symbols;
+};
+
+static void on_symbol_decoded(
+    uint32_t index, const uint8_t* symbol, void* context)
+{
+    auto decoded = static_cast<decoded_symbols*>(context);
+    decoded->indices.push_back(index);
+    decoded->symbols.push_back(symbol);
+}
+
+TEST(test_coders, symbol_decoded_callback)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    decoded_symbols decoded;
+    krlnc_decoder_set_symbol_decoded_callback(
+        decoder, on_symbol_decoded, &decoded);
+
+    std::vector<uint8_t> payload(krlnc_encoder_max_payload_size(encoder));
+
+    // Systematic symbols are reported as soon as they are consumed
+    for (uint32_t i = 0; i < symbols / 2; ++i)
+    {
+        krlnc_encoder_produce_payload(encoder, payload.data());
+        krlnc_decoder_consume_payload(decoder, payload.data());
+
+        ASSERT_EQ(i + 1, decoded.indices.size());
+        EXPECT_EQ(i, decoded.indices.back());
+        EXPECT_EQ(data_out.data() + i * symbol_size, decoded.symbols.back());
+    }
+
+    // The remaining symbols are decoded through elimination
+    krlnc_encoder_set_systematic_off(encoder);
+    while (!krlnc_decoder_is_complete(decoder))
+    {
+        krlnc_encoder_produce_payload(encoder, payload.data());
+        krlnc_decoder_consume_payload(decoder, payload.data());
+    }
+
+    ASSERT_EQ(symbols, decoded.indices.size());
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        EXPECT_EQ(i, decoded.indices[i]);
+        EXPECT_EQ(data_out.data() + i * symbol_size, decoded.symbols[i]);
+    }
+    EXPECT_EQ(data_in, data_out);
+
+    // Symbols are reported again after a reset
+    krlnc_reset_decoder(decoder);
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+    krlnc_decoder_consume_systematic_symbol(decoder, data_in.data(), 3);
+
+    ASSERT_EQ(symbols + 1, decoded.indices.size());
+    EXPECT_EQ(3U, decoded.indices.back());
+
+    // Nothing is reported after the callback is removed
+    krlnc_decoder_set_symbol_decoded_callback(decoder, nullptr, nullptr);
+    krlnc_decoder_consume_systematic_symbol(decoder, data_in.data(), 4);
+    EXPECT_EQ(symbols + 1, decoded.indices.size());
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+}
+
+TEST(test_coders, consume_payloads_batch_status)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    decoded_symbols decoded;
+    krlnc_decoder_set_symbol_decoded_callback(
+        decoder, on_symbol_decoded, &decoded);
+    krlnc_decoder_set_status_updater_on(decoder);
+
+    uint32_t count = 4;
+    uint32_t stride = krlnc_encoder_max_payload_size(encoder);
+    std::vector<uint8_t> payloads(count * stride);
+
+    // The systematic symbols of a batch are reported after the batch
+    krlnc_encoder_produce_payloads(
+        encoder, payloads.data(), count, stride, NULL);
+    krlnc_decoder_consume_payloads(decoder, payloads.data(), count, stride);
+
+    ASSERT_EQ(count, decoded.indices.size());
+    for (uint32_t i = 0; i < count; ++i)
+        EXPECT_EQ(i, decoded.indices[i]);
+
+    // The status updater is only switched off during a batch
+    EXPECT_TRUE(krlnc_decoder_is_status_updater_enabled(decoder));
+
+    krlnc_encoder_set_systematic_off(encoder);
+    while (!krlnc_decoder_is_complete(decoder))
+    {
+        krlnc_encoder_produce_payloads(
+            encoder, payloads.data(), count, stride, NULL);
+        krlnc_decoder_consume_payloads(
+            decoder, payloads.data(), count, stride);
+    }
+
+    EXPECT_EQ(symbols, decoded.indices.size());
+    EXPECT_EQ(symbols, krlnc_decoder_symbols_decoded(decoder));
+    EXPECT_EQ(data_in, data_out);
+
+    krlnc_decoder_stats stats;
+    krlnc_decoder_get_stats(decoder, &stats);
+    EXPECT_EQ(symbols, stats.innovative_payloads);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+}
+
+TEST(test_coders, feedback)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+
+    EXPECT_EQ(krlnc_encoder_feedback_size(encoder),
+              krlnc_decoder_feedback_size(decoder));
+    EXPECT_EQ(4U + symbols / 8, krlnc_decoder_feedback_size(decoder));
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    // The decoder already has the even symbols
+    for (uint32_t i = 0; i < symbols; i += 2)
+    {
+        krlnc_decoder_consume_systematic_symbol(
+            decoder, data_in.data() + i * symbol_size, i);
+    }
+
+    std::vector<uint8_t> feedback(krlnc_decoder_feedback_size(decoder));
+    EXPECT_EQ(feedback.size(),
+              krlnc_decoder_produce_feedback(decoder, feedback.data()));
+    EXPECT_EQ(symbols / 2, feedback[0]);
+    EXPECT_EQ(0x55, feedback[4]);
+    EXPECT_EQ(0x55, feedback[5]);
+
+    krlnc_encoder_consume_feedback(encoder, feedback.data());
+
+    std::vector<uint8_t> payload(
+        krlnc_decoder_max_segmented_payload_size(decoder));
+
+    auto transfer = [&]
+    {
+        krlnc_payload_segments segments;
+        uint32_t bytes_used =
+            krlnc_encoder_produce_payload_segments(encoder, &segments);
+
+        std::copy_n(segments.header, segments.header_size, payload.begin());
+        std::copy_n(segments.symbol, segments.symbol_size,
+                    payload.begin() + segments.header_size);
+
+        krlnc_decoder_consume_segmented_payload(
+            decoder, payload.data(), bytes_used);
+        return segments;
+    };
+
+    // Only the odd symbols are sent systematically, and the first three
+    // are lost
+    for (uint32_t i = 1; i < symbols; i += 2)
+    {
+        krlnc_payload_segments segments;
+        krlnc_encoder_produce_payload_segments(encoder, &segments);
+        EXPECT_EQ(data_in.data() + i * symbol_size, segments.symbol);
+
+        if (i < 6)
+            continue;
+
+        std::copy_n(segments.header, segments.header_size, payload.begin());
+        std::copy_n(segments.symbol, segments.symbol_size,
+                    payload.begin() + segments.header_size);
+
+        krlnc_decoder_consume_segmented_payload(
+            decoder, payload.data(), segments.header_size + symbol_size);
+    }
+    EXPECT_EQ(symbols - 3, krlnc_decoder_rank(decoder));
+
+    // With new feedback, the coded payloads only combine the missing
+    // symbols and every payload is innovative
+    krlnc_decoder_produce_feedback(decoder, feedback.data());
+    krlnc_encoder_consume_feedback(encoder, feedback.data());
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        uint32_t rank = krlnc_decoder_rank(decoder);
+        krlnc_payload_segments segments = transfer();
+
+        for (uint32_t index = 0; index < symbols; ++index)
+        {
+            if (index != 1 && index != 3 && index != 5)
+            {
+                EXPECT_EQ(0U, segments.header[1 + index]);
+            }
+        }
+        EXPECT_EQ(rank + 1, krlnc_decoder_rank(decoder));
+    }
+
+    EXPECT_TRUE(krlnc_decoder_is_complete(decoder));
+    EXPECT_EQ(data_in, data_out);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+}
+
+static void transfer_generation(
+    krlnc_encoder_t encoder, krlnc_decoder_t decoder)
+{
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    std::vector<uint8_t> payload(krlnc_encoder_max_payload_size(encoder));
+    while (!krlnc_decoder_is_complete(decoder))
+    {
+        uint32_t bytes_used =
+            krlnc_encoder_produce_payload(encoder, payload.data());
+        krlnc_decoder_consume_payload_const(
+            decoder, payload.data(), bytes_used);
+    }
+    EXPECT_EQ(data_in, data_out);
+}
+
+TEST(test_coders, reconfigure)
+{
+    auto encoder = krlnc_create_encoder(krlnc_binary8, 16, 160);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, 16, 160);
+
+    // The coders of earlier geometries are only kept on request
+    EXPECT_EQ(0U, krlnc_encoder_reconfigure_cache(encoder));
+    EXPECT_EQ(0U, krlnc_decoder_reconfigure_cache(decoder));
+    krlnc_encoder_set_reconfigure_cache(encoder, 1);
+    krlnc_decoder_set_reconfigure_cache(decoder, 1);
+    EXPECT_EQ(1U, krlnc_encoder_reconfigure_cache(encoder));
+    EXPECT_EQ(1U, krlnc_decoder_reconfigure_cache(decoder));
+
+    krlnc_encoder_set_systematic_off(encoder);
+    transfer_generation(encoder, decoder);
+
+    // A shorter last generation
+    krlnc_encoder_reconfigure(encoder, 5, 100);
+    krlnc_decoder_reconfigure(decoder, 5, 100);
+
+    EXPECT_EQ(5U, krlnc_encoder_symbols(encoder));
+    EXPECT_EQ(100U, krlnc_encoder_symbol_size(encoder));
+    EXPECT_EQ(5U, krlnc_decoder_symbols(decoder));
+    EXPECT_EQ(100U, krlnc_decoder_symbol_size(decoder));
+    EXPECT_EQ(0U, krlnc_decoder_rank(decoder));
+    EXPECT_FALSE(krlnc_encoder_is_systematic_on(encoder));
+
+    transfer_generation(encoder, decoder);
+
+    // Switching back to the first geometry reuses the kept coders
+    krlnc_encoder_reconfigure(encoder, 16, 160);
+    krlnc_decoder_reconfigure(decoder, 16, 160);
+
+    EXPECT_EQ(16U, krlnc_encoder_symbols(encoder));
+    EXPECT_EQ(160U, krlnc_decoder_symbol_size(decoder));
+    EXPECT_FALSE(krlnc_encoder_is_systematic_on(encoder));
+
+    transfer_generation(encoder, decoder);
+
+    // A larger geometry grows the buffers
+    krlnc_decoder_reconfigure(decoder, 32, 160);
+    krlnc_encoder_reconfigure(encoder, 32, 160);
+    transfer_generation(encoder, decoder);
+
+    // The cache can be shrunk again, which releases the kept coders
+    krlnc_encoder_set_reconfigure_cache(encoder, 0);
+    krlnc_decoder_set_reconfigure_cache(decoder, 0);
+    krlnc_encoder_reconfigure(encoder, 5, 100);
+    krlnc_decoder_reconfigure(decoder, 5, 100);
+    transfer_generation(encoder, decoder);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+}
+
+TEST(test_coders, reconfigure_seed)
+{
+    auto encoder = krlnc_create_encoder(krlnc_binary8, 16, 160);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, 16, 160);
+    auto reference = krlnc_create_encoder(krlnc_binary8, 5, 100);
+
+    krlnc_encoder_set_seed(encoder, 42);
+    krlnc_decoder_set_seed(decoder, 42);
+    krlnc_encoder_set_seed(reference, 42);
+
+    // The seed carries over to the new geometry, so both sides generate
+    // the same coefficients as a new coder with that seed
+    krlnc_encoder_reconfigure(encoder, 5, 100);
+    krlnc_decoder_reconfigure(decoder, 5, 100);
+
+    std::vector<uint8_t> expected(5);
+    std::vector<uint8_t> coefficients(5);
+
+    krlnc_encoder_generate(reference, expected.data());
+    krlnc_encoder_generate(encoder, coefficients.data());
+    EXPECT_EQ(expected, coefficients);
+    krlnc_decoder_generate(decoder, coefficients.data());
+    EXPECT_EQ(expected, coefficients);
+
+    // The generator also restarts when the geometry is unchanged
+    krlnc_encoder_reconfigure(encoder, 5, 100);
+    krlnc_encoder_generate(encoder, coefficients.data());
+    EXPECT_EQ(expected, coefficients);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+    krlnc_delete_encoder(reference);
+}
+
+TEST(test_coders, column_threads)
+{
+    uint32_t symbols = 8;
+    uint32_t symbol_size = 100000;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto reference = krlnc_create_encoder(
+        krlnc_binary8, symbols, symbol_size);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+
+    // The storage that is set before the symbols are split is kept
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+    krlnc_encoder_set_symbols_storage(reference, data_in.data());
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    EXPECT_EQ(1U, krlnc_encoder_column_threads(encoder));
+    krlnc_encoder_set_column_threads(encoder, 4);
+    EXPECT_TRUE(krlnc_decoder_set_column_threads(decoder, 4));
+    EXPECT_EQ(4U, krlnc_encoder_column_threads(encoder));
+    EXPECT_EQ(4U, krlnc_decoder_column_threads(decoder));
+
+    // Small symbols are not split
+    auto small = krlnc_create_encoder(krlnc_binary8, symbols, 1000);
+    krlnc_encoder_set_column_threads(small, 4);
+    EXPECT_EQ(1U, krlnc_encoder_column_threads(small));
+    krlnc_delete_encoder(small);
+
+    // The kodo payload format cannot be split, so an empty decoder stops
+    // splitting the symbols when it gets a kodo payload, and the column
+    // threads cannot be turned on again
+    {
+        auto other = krlnc_create_decoder(
+            krlnc_binary8, symbols, symbol_size);
+        std::vector<uint8_t> other_out(krlnc_decoder_block_size(other));
+        krlnc_decoder_set_symbols_storage(other, other_out.data());
+
+        EXPECT_TRUE(krlnc_decoder_set_column_threads(other, 4));
+        EXPECT_EQ(4U, krlnc_decoder_column_threads(other));
+
+        std::vector<uint8_t> payload(
+            krlnc_encoder_max_payload_size(reference));
+        uint32_t bytes_used =
+            krlnc_encoder_produce_payload(reference, payload.data());
+
+        EXPECT_TRUE(krlnc_decoder_consume_payload_const(
+            other, payload.data(), bytes_used));
+        EXPECT_EQ(1U, krlnc_decoder_column_threads(other));
+        EXPECT_EQ(1U, krlnc_decoder_rank(other));
+
+        krlnc_reset_decoder(other);
+        EXPECT_FALSE(krlnc_decoder_set_column_threads(other, 4));
+        EXPECT_EQ(1U, krlnc_decoder_column_threads(other));
+
+        // Restoring the defaults allows the column threads again
+        krlnc_decoder_restore_defaults(other);
+        EXPECT_TRUE(krlnc_decoder_set_column_threads(other, 4));
+        EXPECT_EQ(4U, krlnc_decoder_column_threads(other));
+
+        krlnc_delete_decoder(other);
+
+        krlnc_reset_encoder(reference);
+        krlnc_encoder_set_symbols_storage(reference, data_in.data());
+    }
+
+    // A split symbol is the same as a symbol produced by a single thread
+    std::vector<uint8_t> coefficients(
+        krlnc_encoder_coefficient_vector_size(encoder));
+    std::vector<uint8_t> symbol(symbol_size);
+    std::vector<uint8_t> expected(symbol_size);
+
+    krlnc_encoder_generate(encoder, coefficients.data());
+    EXPECT_EQ(symbol_size, krlnc_encoder_produce_symbol(
+        encoder, symbol.data(), coefficients.data()));
+    krlnc_encoder_produce_symbol(
+        reference, expected.data(), coefficients.data());
+    EXPECT_EQ(expected, symbol);
+
+    uint32_t decoded = 0;
+    krlnc_decoder_set_symbol_decoded_callback(decoder,
+        [](uint32_t, const uint8_t*, void* context)
+        {
+            ++*static_cast<uint32_t*>(context);
+        },
+        &decoded);
+
+    // One systematic symbol, and coded payload segments for the rest
+    krlnc_decoder_consume_systematic_symbol(
+        decoder, data_in.data() + symbol_size, 1);
+    EXPECT_EQ(1U, krlnc_decoder_rank(decoder));
+
+    krlnc_encoder_set_systematic_off(encoder);
+    std::vector<uint8_t> payload(
+        krlnc_decoder_max_segmented_payload_size(decoder));
+
+    while (!krlnc_decoder_is_complete(decoder))
+    {
+        krlnc_payload_segments segments;
+        uint32_t bytes_used =
+            krlnc_encoder_produce_payload_segments(encoder, &segments);
+
+        std::copy_n(segments.header, segments.header_size, payload.begin());
+        std::copy_n(segments.symbol, segments.symbol_size,
+                    payload.begin() + segments.header_size);
+
+        krlnc_decoder_consume_segmented_payload(
+            decoder, payload.data(), bytes_used);
+    }
+
+    EXPECT_EQ(symbols, decoded);
+    EXPECT_EQ(data_in, data_out);
+
+    // The splitting of an empty decoder can be turned off, and it keeps
+    // decoding into the same storage
+    std::fill(data_out.begin(), data_out.end(), 0);
+    krlnc_reset_decoder(decoder);
+    EXPECT_TRUE(krlnc_decoder_set_column_threads(decoder, 1));
+    EXPECT_EQ(1U, krlnc_decoder_column_threads(decoder));
+
+    krlnc_reset_encoder(encoder);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+    payload.resize(krlnc_encoder_max_payload_size(encoder));
+
+    while (!krlnc_decoder_is_complete(decoder))
+    {
+        krlnc_encoder_produce_payload(encoder, payload.data());
+        krlnc_decoder_consume_payload(decoder, payload.data());
+    }
+    EXPECT_EQ(data_in, data_out);
+
+    // The threads are kept when the decoder is reconfigured
+    krlnc_decoder_restore_defaults(decoder);
+    EXPECT_TRUE(krlnc_decoder_set_column_threads(decoder, 4));
+    krlnc_decoder_reconfigure(decoder, symbols / 2, symbol_size);
+    EXPECT_EQ(4U, krlnc_decoder_column_threads(decoder));
+    krlnc_decoder_reconfigure(decoder, symbols, 40000);
+    EXPECT_EQ(2U, krlnc_decoder_column_threads(decoder));
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_encoder(reference);
+    krlnc_delete_decoder(decoder);
+}
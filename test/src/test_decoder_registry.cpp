@@ -0,0 +1,230 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <kodo_rlnc_c/encoder.h>
+#include <kodo_rlnc_c/decoder_registry.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(test_decoder_registry, interleaved_flows)
+{
+    uint32_t symbols = 8;
+    uint32_t symbol_size = 64;
+    uint32_t flows = 5;
+
+    auto registry = krlnc_create_decoder_registry(
+        krlnc_binary8, symbols, symbol_size, 1024 * 1024);
+
+    EXPECT_LE(flows, krlnc_decoder_registry_capacity(registry));
+    EXPECT_EQ(0U, krlnc_decoder_registry_flows(registry));
+
+    std::vector<krlnc_encoder_t> encoders;
+    std::vector<std::vector<uint8_t>> data_in;
+
+    for (uint32_t i = 0; i < flows; ++i)
+    {
+        krlnc_encoder_t encoder = krlnc_create_encoder(
+            krlnc_binary8, symbols, symbol_size);
+
+        std::vector<uint8_t> data(krlnc_encoder_block_size(encoder));
+        std::generate(data.begin(), data.end(), rand);
+        data_in.push_back(data);
+
+        krlnc_encoder_set_symbols_storage(encoder, data_in.back().data());
+        encoders.push_back(encoder);
+    }
+
+    // The flow ids are far apart to make sure they are not used as indices
+    auto flow_id = [](uint32_t i) { return (uint64_t{i} << 40) + 7; };
+
+    std::vector<uint8_t> payload(krlnc_encoder_max_payload_size(encoders[0]));
+
+    // Send the payloads of all flows interleaved
+    for (uint32_t round = 0; round < symbols; ++round)
+    {
+        for (uint32_t i = 0; i < flows; ++i)
+        {
+            krlnc_encoder_produce_payload(encoders[i], payload.data());
+            krlnc_decoder_t decoder = krlnc_decoder_registry_consume_payload(
+                registry, flow_id(i), payload.data());
+
+            EXPECT_EQ(decoder, krlnc_decoder_registry_find(
+                registry, flow_id(i)));
+            EXPECT_EQ(round + 1, krlnc_decoder_rank(decoder));
+        }
+    }
+
+    EXPECT_EQ(flows, krlnc_decoder_registry_flows(registry));
+    EXPECT_EQ(0U, krlnc_decoder_registry_evictions(registry));
+
+    for (uint32_t i = 0; i < flows; ++i)
+    {
+        krlnc_decoder_t decoder = krlnc_decoder_registry_find(
+            registry, flow_id(i));
+        ASSERT_NE(nullptr, decoder);
+        EXPECT_TRUE(krlnc_decoder_is_complete(decoder) != 0);
+
+        const uint8_t* data_out = krlnc_decoder_registry_flow_data(
+            registry, flow_id(i));
+        ASSERT_NE(nullptr, data_out);
+        EXPECT_EQ(0, memcmp(data_in[i].data(), data_out, data_in[i].size()));
+
+        EXPECT_TRUE(krlnc_decoder_registry_remove(registry, flow_id(i)) != 0);
+        EXPECT_EQ(nullptr, krlnc_decoder_registry_find(registry, flow_id(i)));
+    }
+
+    EXPECT_EQ(0U, krlnc_decoder_registry_flows(registry));
+    EXPECT_FALSE(krlnc_decoder_registry_remove(registry, flow_id(0)) != 0);
+
+    for (auto encoder : encoders)
+        krlnc_delete_encoder(encoder);
+
+    krlnc_delete_decoder_registry(registry);
+}
+
+TEST(test_decoder_registry, eviction)
+{
+    uint32_t symbols = 4;
+    uint32_t symbol_size = 16;
+
+    // A budget smaller than one decoder still allows a single flow
+    auto tiny = krlnc_create_decoder_registry(
+        krlnc_binary8, symbols, symbol_size, 1);
+    EXPECT_EQ(1U, krlnc_decoder_registry_capacity(tiny));
+    krlnc_delete_decoder_registry(tiny);
+
+    // Find the cost of a flow from the budget that fits exactly one flow
+    uint64_t flow_size = 1;
+    while (true)
+    {
+        auto probe = krlnc_create_decoder_registry(
+            krlnc_binary8, symbols, symbol_size, flow_size * 3);
+        uint32_t capacity = krlnc_decoder_registry_capacity(probe);
+        krlnc_delete_decoder_registry(probe);
+        if (capacity == 3)
+            break;
+        ++flow_size;
+    }
+
+    auto registry = krlnc_create_decoder_registry(
+        krlnc_binary8, symbols, symbol_size, flow_size * 3);
+
+    std::vector<uint64_t> evicted;
+    krlnc_decoder_registry_set_eviction_callback(registry,
+        [](uint64_t flow_id, krlnc_decoder_t decoder, const uint8_t* data,
+           void* context)
+        {
+            EXPECT_NE(nullptr, decoder);
+            EXPECT_NE(nullptr, data);
+            static_cast<std::vector<uint64_t>*>(context)->push_back(flow_id);
+        },
+        &evicted);
+
+    krlnc_encoder_t encoder = krlnc_create_encoder(
+        krlnc_binary8, symbols, symbol_size);
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+    std::vector<uint8_t> payload(krlnc_encoder_max_payload_size(encoder));
+
+    auto consume = [&](uint64_t flow_id)
+    {
+        krlnc_encoder_produce_payload(encoder, payload.data());
+        krlnc_decoder_registry_consume_payload(
+            registry, flow_id, payload.data());
+    };
+
+    consume(1);
+    consume(2);
+    consume(3);
+
+    // Flow 1 becomes the most recently used, so flow 2 is evicted next
+    consume(1);
+    consume(4);
+
+    EXPECT_EQ(3U, krlnc_decoder_registry_flows(registry));
+    EXPECT_EQ(1U, krlnc_decoder_registry_evictions(registry));
+    ASSERT_EQ(1U, evicted.size());
+    EXPECT_EQ(2U, evicted[0]);
+    EXPECT_EQ(nullptr, krlnc_decoder_registry_find(registry, 2));
+    EXPECT_EQ(2U, krlnc_decoder_rank(
+        krlnc_decoder_registry_find(registry, 1)));
+
+    // Removed flows are not reported as evicted
+    EXPECT_TRUE(krlnc_decoder_registry_remove(registry, 3) != 0);
+    consume(5);
+    EXPECT_EQ(1U, evicted.size());
+
+    consume(6);
+    ASSERT_EQ(2U, evicted.size());
+    EXPECT_EQ(1U, evicted[1]);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder_registry(registry);
+}
+
+TEST(test_decoder_registry, many_flows)
+{
+    uint32_t symbols = 4;
+    uint32_t symbol_size = 16;
+
+    auto registry = krlnc_create_decoder_registry(
+        krlnc_binary8, symbols, symbol_size, 64 * 1024);
+    uint32_t capacity = krlnc_decoder_registry_capacity(registry);
+
+    krlnc_encoder_t encoder = krlnc_create_encoder(
+        krlnc_binary8, symbols, symbol_size);
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+    std::vector<uint8_t> payload(krlnc_encoder_max_payload_size(encoder));
+
+    // Compare the registry with a model, while flows are added and removed
+    // in a random order to exercise the index
+    std::map<uint64_t, krlnc_decoder_t> model;
+    srand(1);
+
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        uint64_t flow_id = rand() % (2 * capacity);
+
+        if (rand() % 3 == 0)
+        {
+            uint8_t removed = krlnc_decoder_registry_remove(registry, flow_id);
+            EXPECT_EQ(model.erase(flow_id), removed);
+            continue;
+        }
+
+        // Stay below the capacity, so no flow is evicted
+        if (model.count(flow_id) == 0 && model.size() == capacity)
+            continue;
+
+        krlnc_encoder_produce_payload(encoder, payload.data());
+        krlnc_decoder_t decoder = krlnc_decoder_registry_consume_payload(
+            registry, flow_id, payload.data());
+
+        if (model.count(flow_id) != 0)
+        {
+            EXPECT_EQ(model[flow_id], decoder);
+        }
+        model[flow_id] = decoder;
+    }
+
+    EXPECT_EQ(model.size(), krlnc_decoder_registry_flows(registry));
+    EXPECT_EQ(0U, krlnc_decoder_registry_evictions(registry));
+
+    for (uint64_t flow_id = 0; flow_id < 2 * capacity; ++flow_id)
+    {
+        auto it = model.find(flow_id);
+        krlnc_decoder_t expected = it == model.end() ? nullptr : it->second;
+        EXPECT_EQ(expected, krlnc_decoder_registry_find(registry, flow_id));
+    }
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder_registry(registry);
+}
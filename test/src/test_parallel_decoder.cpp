@@ -0,0 +1,146 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <kodo_rlnc_c/encoder.h>
+#include <kodo_rlnc_c/parallel_decoder.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Decode a generation from the payload segments of an encoder, where the
+// first systematic payloads are lost
+static void decode_generation(uint32_t symbols, uint32_t symbol_size,
+                              uint32_t threads)
+{
+    krlnc_encoder_t encoder = krlnc_create_encoder(
+        krlnc_binary8, symbols, symbol_size);
+    krlnc_parallel_decoder_t decoder = krlnc_create_parallel_decoder(
+        symbols, symbol_size, threads);
+
+    EXPECT_EQ(threads, krlnc_parallel_decoder_threads(decoder));
+    EXPECT_EQ(krlnc_encoder_block_size(encoder),
+              krlnc_parallel_decoder_block_size(decoder));
+    EXPECT_EQ(krlnc_encoder_coefficient_vector_size(encoder),
+              krlnc_parallel_decoder_coefficient_vector_size(decoder));
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::vector<uint8_t> data_out(krlnc_parallel_decoder_block_size(decoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+    krlnc_parallel_decoder_set_symbols_storage(decoder, data_out.data());
+
+    std::vector<uint8_t> payload(
+        krlnc_parallel_decoder_max_segmented_payload_size(decoder));
+
+    uint32_t payloads = 0;
+    while (!krlnc_parallel_decoder_is_complete(decoder))
+    {
+        krlnc_payload_segments segments;
+        uint32_t bytes_used =
+            krlnc_encoder_produce_payload_segments(encoder, &segments);
+
+        if (++payloads <= symbols / 2)
+            continue;
+
+        std::copy_n(segments.header, segments.header_size, payload.begin());
+        std::copy_n(segments.symbol, segments.symbol_size,
+                    payload.begin() + segments.header_size);
+
+        krlnc_parallel_decoder_consume_segmented_payload(
+            decoder, payload.data(), bytes_used);
+
+        // The systematic symbols are decoded as soon as they arrive
+        if (payloads <= symbols)
+        {
+            EXPECT_TRUE(krlnc_parallel_decoder_is_symbol_decoded(
+                decoder, payloads - 1) != 0);
+        }
+    }
+
+    EXPECT_EQ(symbols, krlnc_parallel_decoder_rank(decoder));
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        EXPECT_TRUE(krlnc_parallel_decoder_is_symbol_pivot(decoder, i) != 0);
+        EXPECT_TRUE(krlnc_parallel_decoder_is_symbol_decoded(decoder, i) != 0);
+    }
+    EXPECT_EQ(data_in, data_out);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_parallel_decoder(decoder);
+}
+
+TEST(test_parallel_decoder, small_generation)
+{
+    decode_generation(16, 100, 1);
+    decode_generation(16, 100, 4);
+}
+
+TEST(test_parallel_decoder, large_generation)
+{
+    // Large enough that the elimination is split across the workers
+    decode_generation(256, 2000, 1);
+    decode_generation(256, 2000, 4);
+}
+
+TEST(test_parallel_decoder, symbols)
+{
+    uint32_t symbols = 64;
+    uint32_t symbol_size = 4000;
+
+    krlnc_encoder_t encoder = krlnc_create_encoder(
+        krlnc_binary8, symbols, symbol_size);
+    krlnc_parallel_decoder_t decoder = krlnc_create_parallel_decoder(
+        symbols, symbol_size, 3);
+
+    // The affinity is only supported on some platforms, but decoding
+    // works either way
+    uint32_t cpus[] = { 0 };
+    krlnc_parallel_decoder_set_thread_affinity(decoder, cpus, 1);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::vector<uint8_t> data_out(krlnc_parallel_decoder_block_size(decoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+    krlnc_parallel_decoder_set_symbols_storage(decoder, data_out.data());
+
+    std::vector<uint8_t> coefficients(
+        krlnc_encoder_coefficient_vector_size(encoder));
+    std::vector<uint8_t> symbol(symbol_size);
+
+    for (uint32_t generation = 0; generation < 2; ++generation)
+    {
+        // Half of the rank comes from coded symbols, and the rest from
+        // systematic symbols
+        for (uint32_t i = 0; i < symbols / 2; ++i)
+        {
+            krlnc_encoder_generate(encoder, coefficients.data());
+            krlnc_encoder_produce_symbol(
+                encoder, symbol.data(), coefficients.data());
+            krlnc_parallel_decoder_consume_symbol(
+                decoder, symbol.data(), coefficients.data());
+        }
+        EXPECT_EQ(symbols / 2, krlnc_parallel_decoder_rank(decoder));
+
+        for (uint32_t i = 0; i < symbols; ++i)
+        {
+            krlnc_parallel_decoder_consume_systematic_symbol(
+                decoder, data_in.data() + i * symbol_size, i);
+        }
+
+        EXPECT_TRUE(krlnc_parallel_decoder_is_complete(decoder) != 0);
+        EXPECT_EQ(data_in, data_out);
+
+        krlnc_reset_parallel_decoder(decoder);
+        EXPECT_EQ(0U, krlnc_parallel_decoder_rank(decoder));
+        std::fill(data_out.begin(), data_out.end(), 0);
+    }
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_parallel_decoder(decoder);
+}
@@ -0,0 +1,109 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <kodo_rlnc_c/parallel_encoder.h>
+#include <kodo_rlnc_c/block_decoder.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(test_parallel_encoder, encode_all_generations)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 100;
+    uint32_t threads = 4;
+    uint64_t size = symbols * symbol_size * 37 + 55;
+
+    auto encoder = krlnc_create_parallel_encoder(
+        krlnc_binary8, symbols, symbol_size, threads);
+    auto decoder = krlnc_create_block_decoder(
+        krlnc_binary8, symbols, symbol_size);
+
+    EXPECT_EQ(threads, krlnc_parallel_encoder_threads(encoder));
+    EXPECT_EQ(krlnc_block_decoder_max_payload_size(decoder),
+              krlnc_parallel_encoder_max_payload_size(encoder));
+
+    std::vector<uint8_t> data_in(size);
+    std::generate(data_in.begin(), data_in.end(), rand);
+    std::vector<uint8_t> data_out(size);
+
+    krlnc_parallel_encoder_set_systematic_off(encoder);
+    krlnc_parallel_encoder_set_data(encoder, data_in.data(), size);
+    krlnc_block_decoder_set_data(decoder, data_out.data(), size);
+
+    uint32_t generations = krlnc_parallel_encoder_generations(encoder);
+    EXPECT_EQ(38U, generations);
+
+    uint32_t stride = krlnc_parallel_encoder_max_payload_size(encoder);
+    uint32_t payloads = symbols + 8;
+
+    // Encode the generations in two ranges
+    uint32_t collected = 0;
+    std::vector<uint8_t> seen(generations, 0);
+    uint32_t ranges[2][2] = {{0, 20}, {20, generations - 20}};
+
+    for (auto& range : ranges)
+    {
+        krlnc_parallel_encoder_start(encoder, range[0], range[1], payloads);
+
+        uint32_t range_collected = 0;
+        while (range_collected < range[1])
+        {
+            uint32_t generation = 0;
+            const uint8_t* data = nullptr;
+            const uint32_t* sizes = nullptr;
+
+            if (!krlnc_parallel_encoder_collect(
+                    encoder, &generation, &data, &sizes))
+            {
+                continue;
+            }
+
+            EXPECT_GE(generation, range[0]);
+            EXPECT_LT(generation, range[0] + range[1]);
+            EXPECT_FALSE(seen[generation]);
+            seen[generation] = 1;
+
+            std::vector<uint8_t> payload(stride);
+            for (uint32_t i = 0; i < payloads; ++i)
+            {
+                EXPECT_LE(sizes[i], stride);
+                std::copy_n(data + i * stride, sizes[i], payload.begin());
+                krlnc_block_decoder_consume_payload(
+                    decoder, payload.data(), sizes[i]);
+            }
+            ++range_collected;
+        }
+        collected += range_collected;
+
+        krlnc_parallel_encoder_wait(encoder);
+    }
+
+    EXPECT_EQ(generations, collected);
+    EXPECT_TRUE(krlnc_block_decoder_is_complete(decoder));
+    EXPECT_EQ(data_in, data_out);
+
+    krlnc_delete_parallel_encoder(encoder);
+    krlnc_delete_block_decoder(decoder);
+}
+
+TEST(test_parallel_encoder, delete_while_running)
+{
+    uint32_t symbols = 8;
+    uint32_t symbol_size = 64;
+    uint64_t size = symbols * symbol_size * 10;
+
+    auto encoder = krlnc_create_parallel_encoder(
+        krlnc_binary8, symbols, symbol_size, 0);
+    EXPECT_LE(1U, krlnc_parallel_encoder_threads(encoder));
+
+    std::vector<uint8_t> data_in(size);
+    krlnc_parallel_encoder_set_data(encoder, data_in.data(), size);
+    krlnc_parallel_encoder_start(encoder, 0, 10, symbols);
+
+    krlnc_delete_parallel_encoder(encoder);
+}
@@ -0,0 +1,137 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <kodo_rlnc_c/encoder.h>
+#include <kodo_rlnc_c/decoder.h>
+#include <kodo_rlnc_c/payload_ring.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(test_payload_ring, full_and_empty)
+{
+    auto ring = krlnc_create_payload_ring(3, 10);
+
+    EXPECT_EQ(4U, krlnc_payload_ring_slots(ring));
+    EXPECT_EQ(10U, krlnc_payload_ring_slot_size(ring));
+    EXPECT_EQ(0U, krlnc_payload_ring_size(ring));
+
+    uint32_t size = 0;
+    EXPECT_EQ(nullptr, krlnc_payload_ring_peek(ring, &size));
+
+    // Wrap around the ring several times
+    for (uint32_t round = 0; round < 3; ++round)
+    {
+        std::vector<uint8_t*> slots;
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            uint8_t* slot = krlnc_payload_ring_acquire(ring);
+            ASSERT_NE(nullptr, slot);
+
+            // The slot is kept until it is published
+            EXPECT_EQ(slot, krlnc_payload_ring_acquire(ring));
+
+            memset(slot, round * 4 + i, i + 1);
+            krlnc_payload_ring_publish(ring, i + 1);
+            slots.push_back(slot);
+        }
+
+        // The slots are distinct and all in use
+        std::sort(slots.begin(), slots.end());
+        EXPECT_TRUE(std::unique(slots.begin(), slots.end()) == slots.end());
+        EXPECT_EQ(nullptr, krlnc_payload_ring_acquire(ring));
+        EXPECT_EQ(4U, krlnc_payload_ring_size(ring));
+
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            uint8_t* payload = krlnc_payload_ring_peek(ring, &size);
+            ASSERT_NE(nullptr, payload);
+            EXPECT_EQ(i + 1, size);
+            EXPECT_EQ(round * 4 + i, payload[0]);
+            EXPECT_EQ(round * 4 + i, payload[size - 1]);
+
+            krlnc_payload_ring_release(ring);
+
+            // A released slot can be acquired by the producer again
+            EXPECT_NE(nullptr, krlnc_payload_ring_acquire(ring));
+        }
+
+        EXPECT_EQ(nullptr, krlnc_payload_ring_peek(ring, &size));
+        EXPECT_EQ(0U, krlnc_payload_ring_size(ring));
+    }
+
+    krlnc_delete_payload_ring(ring);
+}
+
+TEST(test_payload_ring, coding_thread)
+{
+    uint32_t symbols = 32;
+    uint32_t symbol_size = 200;
+
+    krlnc_encoder_t encoder = krlnc_create_encoder(
+        krlnc_binary8, symbols, symbol_size);
+    krlnc_decoder_t decoder = krlnc_create_decoder(
+        krlnc_binary8, symbols, symbol_size);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    // A small ring makes the producer wait for the consumer
+    auto ring = krlnc_create_payload_ring(
+        4, krlnc_decoder_max_payload_size(decoder));
+
+    std::atomic<bool> done{false};
+
+    // The consumer decodes the payloads in place and releases the slots
+    std::thread consumer([&]
+    {
+        while (!krlnc_decoder_is_complete(decoder))
+        {
+            uint32_t size = 0;
+            uint8_t* payload = krlnc_payload_ring_peek(ring, &size);
+            if (payload == nullptr)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            EXPECT_LE(size, krlnc_decoder_max_payload_size(decoder));
+            krlnc_decoder_consume_payload(decoder, payload);
+            krlnc_payload_ring_release(ring);
+        }
+        done = true;
+    });
+
+    // The producer encodes into the free slots
+    while (!done)
+    {
+        uint8_t* slot = krlnc_payload_ring_acquire(ring);
+        if (slot == nullptr)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        krlnc_payload_ring_publish(
+            ring, krlnc_encoder_produce_payload(encoder, slot));
+    }
+
+    consumer.join();
+
+    EXPECT_EQ(data_in, data_out);
+
+    krlnc_delete_payload_ring(ring);
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_decoder(decoder);
+}
@@ -0,0 +1,187 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <kodo_rlnc_c/encoder.h>
+#include <kodo_rlnc_c/decoder.h>
+#include <kodo_rlnc_c/recoder.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// Gather the segments of a payload into a contiguous buffer
+static uint32_t gather(const krlnc_payload_segments& segments,
+                       std::vector<uint8_t>& payload)
+{
+    std::copy_n(segments.header, segments.header_size, payload.begin());
+    std::copy_n(segments.symbol, segments.symbol_size,
+                payload.begin() + segments.header_size);
+    return segments.header_size + segments.symbol_size;
+}
+
+TEST(test_recoder, relay)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto recoder = krlnc_create_recoder(symbols, symbol_size, 0);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+
+    EXPECT_EQ(symbols, krlnc_recoder_capacity(recoder));
+    EXPECT_EQ(symbols, krlnc_recoder_symbols(recoder));
+    EXPECT_EQ(symbol_size, krlnc_recoder_symbol_size(recoder));
+    EXPECT_EQ(krlnc_encoder_max_segmented_payload_size(encoder),
+              krlnc_recoder_max_payload_size(recoder));
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    std::vector<uint8_t> payload(krlnc_recoder_max_payload_size(recoder));
+
+    // Nothing can be recoded before a payload is received
+    EXPECT_EQ(0U, krlnc_recoder_produce_payload(recoder, payload.data()));
+
+    // The relay receives systematic and coded payloads, and every third
+    // payload from the source is lost
+    uint32_t sent = 0;
+    while (krlnc_recoder_rank(recoder) < symbols)
+    {
+        krlnc_payload_segments segments;
+        krlnc_encoder_produce_payload_segments(encoder, &segments);
+        uint32_t bytes_used = gather(segments, payload);
+
+        if (++sent % 3 == 0)
+            continue;
+
+        uint32_t rank = krlnc_recoder_rank(recoder);
+        krlnc_recoder_consume_payload(recoder, payload.data(), bytes_used);
+        EXPECT_EQ(rank + 1, krlnc_recoder_rank(recoder));
+
+        // A linearly dependent payload is not stored
+        krlnc_recoder_consume_payload(recoder, payload.data(), bytes_used);
+        EXPECT_EQ(rank + 1, krlnc_recoder_rank(recoder));
+    }
+
+    // The decoder only receives recoded payloads
+    while (!krlnc_decoder_is_complete(decoder))
+    {
+        uint32_t bytes_used =
+            krlnc_recoder_produce_payload(recoder, payload.data());
+        EXPECT_EQ(payload.size(), bytes_used);
+
+        krlnc_decoder_consume_segmented_payload(
+            decoder, payload.data(), bytes_used);
+    }
+    EXPECT_EQ(data_in, data_out);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_recoder(recoder);
+    krlnc_delete_decoder(decoder);
+}
+
+TEST(test_recoder, capacity)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+    uint32_t capacity = 4;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto recoder = krlnc_create_recoder(symbols, symbol_size, capacity);
+    auto decoder = krlnc_create_decoder(krlnc_binary8, symbols, symbol_size);
+
+    EXPECT_EQ(capacity, krlnc_recoder_capacity(recoder));
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+    krlnc_encoder_set_systematic_off(encoder);
+
+    std::vector<uint8_t> data_out(krlnc_decoder_block_size(decoder));
+    krlnc_decoder_set_symbols_storage(decoder, data_out.data());
+
+    std::vector<uint8_t> payload(krlnc_recoder_max_payload_size(recoder));
+
+    // The recoder stops storing payloads when it is full
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        krlnc_payload_segments segments;
+        krlnc_encoder_produce_payload_segments(encoder, &segments);
+        uint32_t bytes_used = gather(segments, payload);
+        krlnc_recoder_consume_payload(recoder, payload.data(), bytes_used);
+    }
+    EXPECT_EQ(capacity, krlnc_recoder_rank(recoder));
+
+    // The recoded payloads span the stored payloads
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        uint32_t bytes_used =
+            krlnc_recoder_produce_payload(recoder, payload.data());
+        krlnc_decoder_consume_segmented_payload(
+            decoder, payload.data(), bytes_used);
+    }
+    EXPECT_EQ(capacity, krlnc_decoder_rank(decoder));
+
+    // A reset recoder starts over
+    krlnc_reset_recoder(recoder);
+    EXPECT_EQ(0U, krlnc_recoder_rank(recoder));
+    EXPECT_EQ(0U, krlnc_recoder_produce_payload(recoder, payload.data()));
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_recoder(recoder);
+    krlnc_delete_decoder(decoder);
+}
+
+TEST(test_recoder, seed)
+{
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    auto encoder = krlnc_create_encoder(krlnc_binary8, symbols, symbol_size);
+    auto recoder1 = krlnc_create_recoder(symbols, symbol_size, 0);
+    auto recoder2 = krlnc_create_recoder(symbols, symbol_size, 0);
+
+    std::vector<uint8_t> data_in(krlnc_encoder_block_size(encoder));
+    std::generate(data_in.begin(), data_in.end(), rand);
+    krlnc_encoder_set_symbols_storage(encoder, data_in.data());
+
+    std::vector<uint8_t> payload(krlnc_recoder_max_payload_size(recoder1));
+
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        krlnc_payload_segments segments;
+        krlnc_encoder_produce_payload_segments(encoder, &segments);
+        uint32_t bytes_used = gather(segments, payload);
+
+        krlnc_recoder_consume_payload(recoder1, payload.data(), bytes_used);
+        krlnc_recoder_consume_payload(recoder2, payload.data(), bytes_used);
+    }
+
+    std::vector<uint8_t> payload1(payload.size());
+    std::vector<uint8_t> payload2(payload.size());
+
+    // Every recoder is seeded randomly, so two relays with the same
+    // payloads send different combinations
+    krlnc_recoder_produce_payload(recoder1, payload1.data());
+    krlnc_recoder_produce_payload(recoder2, payload2.data());
+    EXPECT_NE(payload1, payload2);
+
+    // The same seed gives the same combinations
+    krlnc_recoder_set_seed(recoder1, 42);
+    krlnc_recoder_set_seed(recoder2, 42);
+    krlnc_recoder_produce_payload(recoder1, payload1.data());
+    krlnc_recoder_produce_payload(recoder2, payload2.data());
+    EXPECT_EQ(payload1, payload2);
+
+    krlnc_delete_encoder(encoder);
+    krlnc_delete_recoder(recoder1);
+    krlnc_delete_recoder(recoder2);
+}
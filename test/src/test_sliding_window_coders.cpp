@@ -0,0 +1,312 @@
+// Copyright Steinwurf ApS 2018.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <kodo_rlnc_c/sliding_window_encoder.h>
+#include <kodo_rlnc_c/sliding_window_decoder.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(test_sliding_window_coders, stream)
+{
+    uint32_t capacity = 16;
+    uint32_t symbol_size = 100;
+    uint32_t symbols = 200;
+
+    auto encoder =
+        krlnc_create_sliding_window_encoder(capacity, symbol_size);
+    auto decoder =
+        krlnc_create_sliding_window_decoder(capacity, symbol_size);
+
+    EXPECT_EQ(capacity, krlnc_sliding_window_encoder_capacity(encoder));
+    EXPECT_EQ(symbol_size, krlnc_sliding_window_decoder_symbol_size(decoder));
+    EXPECT_EQ(krlnc_sliding_window_encoder_max_payload_size(encoder),
+              krlnc_sliding_window_decoder_max_payload_size(decoder));
+
+    std::vector<uint8_t> data_in(symbols * symbol_size);
+    std::generate(data_in.begin(), data_in.end(), rand);
+    std::vector<uint8_t> data_out(symbols * symbol_size);
+
+    std::vector<uint8_t> payload(
+        krlnc_sliding_window_encoder_max_payload_size(encoder));
+
+    uint32_t delivered = 0;
+
+    // Deliver the decoded symbols in order and acknowledge them at once
+    auto deliver = [&]
+    {
+        uint32_t next = krlnc_sliding_window_decoder_next_missing_symbol(
+            decoder);
+
+        for (; delivered < next; ++delivered)
+        {
+            const uint8_t* symbol =
+                krlnc_sliding_window_decoder_symbol_data(decoder, delivered);
+            ASSERT_TRUE(symbol != nullptr);
+            std::copy_n(symbol, symbol_size,
+                        data_out.begin() + delivered * symbol_size);
+        }
+
+        krlnc_sliding_window_decoder_retire_symbols(decoder, delivered);
+        krlnc_sliding_window_encoder_retire_symbols(encoder, delivered);
+    };
+
+    auto transfer = [&]
+    {
+        uint32_t bytes_used = krlnc_sliding_window_encoder_produce_payload(
+            encoder, payload.data());
+        EXPECT_LE(bytes_used, payload.size());
+
+        krlnc_sliding_window_decoder_consume_payload(
+            decoder, payload.data(), bytes_used);
+    };
+
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        EXPECT_EQ(i, krlnc_sliding_window_encoder_window_end(encoder));
+        ASSERT_TRUE(krlnc_sliding_window_encoder_push_symbol(
+            encoder, data_in.data() + i * symbol_size));
+
+        // Every fifth systematic payload is lost
+        if (i % 5 == 2)
+        {
+            krlnc_sliding_window_encoder_produce_payload(
+                encoder, payload.data());
+        }
+        else
+        {
+            transfer();
+        }
+
+        // Repair payloads are sent after every fourth symbol
+        if (i % 4 == 3)
+        {
+            transfer();
+            transfer();
+        }
+
+        deliver();
+
+        // The acknowledgements keep the window small
+        EXPECT_LE(krlnc_sliding_window_encoder_window_end(encoder) -
+                  krlnc_sliding_window_encoder_window_start(encoder), 4U);
+    }
+
+    while (delivered < symbols)
+    {
+        transfer();
+        deliver();
+    }
+
+    EXPECT_EQ(data_in, data_out);
+    EXPECT_EQ(symbols, krlnc_sliding_window_decoder_window_start(decoder));
+    EXPECT_EQ(0U, krlnc_sliding_window_decoder_rank(decoder));
+
+    // An empty window produces no payload
+    EXPECT_EQ(0U, krlnc_sliding_window_encoder_produce_payload(
+        encoder, payload.data()));
+
+    krlnc_delete_sliding_window_encoder(encoder);
+    krlnc_delete_sliding_window_decoder(decoder);
+}
+
+TEST(test_sliding_window_coders, delayed_acknowledgements)
+{
+    uint32_t capacity = 16;
+    uint32_t symbol_size = 100;
+    uint32_t symbols = 200;
+    uint32_t delay = 3;
+
+    auto encoder =
+        krlnc_create_sliding_window_encoder(capacity, symbol_size);
+    auto decoder =
+        krlnc_create_sliding_window_decoder(capacity, symbol_size);
+
+    std::vector<uint8_t> data_in(symbols * symbol_size);
+    std::generate(data_in.begin(), data_in.end(), rand);
+    std::vector<uint8_t> data_out(symbols * symbol_size);
+
+    std::vector<uint8_t> payload(
+        krlnc_sliding_window_encoder_max_payload_size(encoder));
+
+    uint32_t delivered = 0;
+
+    // The acknowledgements that are on their way to the encoder, so the
+    // encoder keeps coding over symbols that the decoder has retired
+    std::deque<uint32_t> acknowledgements(delay, 0);
+    uint32_t early_repairs = 0;
+
+    auto deliver = [&]
+    {
+        uint32_t next = krlnc_sliding_window_decoder_next_missing_symbol(
+            decoder);
+
+        for (; delivered < next; ++delivered)
+        {
+            const uint8_t* symbol =
+                krlnc_sliding_window_decoder_symbol_data(decoder, delivered);
+            ASSERT_TRUE(symbol != nullptr);
+            std::copy_n(symbol, symbol_size,
+                        data_out.begin() + delivered * symbol_size);
+        }
+
+        krlnc_sliding_window_decoder_retire_symbols(decoder, delivered);
+
+        acknowledgements.push_back(delivered);
+        krlnc_sliding_window_encoder_retire_symbols(
+            encoder, acknowledgements.front());
+        acknowledgements.pop_front();
+    };
+
+    auto transfer = [&]
+    {
+        uint32_t bytes_used = krlnc_sliding_window_encoder_produce_payload(
+            encoder, payload.data());
+
+        krlnc_sliding_window_decoder_consume_payload(
+            decoder, payload.data(), bytes_used);
+    };
+
+    for (uint32_t i = 0; i < symbols; ++i)
+    {
+        ASSERT_TRUE(krlnc_sliding_window_encoder_push_symbol(
+            encoder, data_in.data() + i * symbol_size));
+
+        // Every fifth systematic payload is lost
+        if (i % 5 == 2)
+        {
+            krlnc_sliding_window_encoder_produce_payload(
+                encoder, payload.data());
+        }
+        else
+        {
+            transfer();
+        }
+
+        // The repair payloads often start before the window of the
+        // decoder, and they must still recover the lost symbols
+        if (i % 4 == 3)
+        {
+            if (krlnc_sliding_window_encoder_window_start(encoder) <
+                krlnc_sliding_window_decoder_window_start(decoder))
+            {
+                ++early_repairs;
+            }
+
+            transfer();
+            transfer();
+
+            // The lost symbol is recovered at once, without waiting for
+            // the encoder to catch up
+            EXPECT_EQ(krlnc_sliding_window_decoder_window_end(decoder),
+                      krlnc_sliding_window_decoder_next_missing_symbol(
+                          decoder));
+        }
+
+        deliver();
+    }
+
+    EXPECT_GT(early_repairs, 0U);
+
+    while (delivered < symbols)
+    {
+        transfer();
+        deliver();
+    }
+
+    EXPECT_EQ(data_in, data_out);
+
+    krlnc_delete_sliding_window_encoder(encoder);
+    krlnc_delete_sliding_window_decoder(decoder);
+}
+
+TEST(test_sliding_window_coders, full_window)
+{
+    uint32_t capacity = 8;
+    uint32_t symbol_size = 64;
+
+    auto encoder =
+        krlnc_create_sliding_window_encoder(capacity, symbol_size);
+    auto decoder =
+        krlnc_create_sliding_window_decoder(capacity, symbol_size);
+
+    krlnc_sliding_window_encoder_set_systematic_off(encoder);
+
+    std::vector<uint8_t> data_in(2 * capacity * symbol_size);
+    std::generate(data_in.begin(), data_in.end(), rand);
+
+    for (uint32_t i = 0; i < capacity; ++i)
+    {
+        EXPECT_TRUE(krlnc_sliding_window_encoder_push_symbol(
+            encoder, data_in.data() + i * symbol_size));
+    }
+
+    // The window is full until symbols are retired
+    EXPECT_FALSE(krlnc_sliding_window_encoder_push_symbol(
+        encoder, data_in.data()));
+
+    std::vector<uint8_t> payload(
+        krlnc_sliding_window_encoder_max_payload_size(encoder));
+
+    // Coded payloads decode the whole window, apart from an unlikely
+    // linearly dependent payload
+    for (uint32_t i = 0; i < capacity + 2; ++i)
+    {
+        uint32_t bytes_used = krlnc_sliding_window_encoder_produce_payload(
+            encoder, payload.data());
+        krlnc_sliding_window_decoder_consume_payload(
+            decoder, payload.data(), bytes_used);
+    }
+
+    EXPECT_EQ(capacity, krlnc_sliding_window_decoder_rank(decoder));
+    for (uint32_t i = 0; i < capacity; ++i)
+    {
+        const uint8_t* symbol =
+            krlnc_sliding_window_decoder_symbol_data(decoder, i);
+        ASSERT_TRUE(symbol != nullptr);
+        EXPECT_TRUE(std::equal(symbol, symbol + symbol_size,
+                               data_in.begin() + i * symbol_size));
+    }
+
+    // A payload from an older window is reduced with the retired symbols,
+    // which leaves no new information
+    krlnc_sliding_window_decoder_retire_symbols(decoder, capacity / 2);
+    krlnc_sliding_window_decoder_consume_payload(
+        decoder, payload.data(), (uint32_t)payload.size());
+    EXPECT_EQ(capacity / 2, krlnc_sliding_window_decoder_rank(decoder));
+    EXPECT_EQ(capacity / 2,
+              krlnc_sliding_window_decoder_next_missing_symbol(decoder) -
+              krlnc_sliding_window_decoder_window_start(decoder));
+
+    // A payload beyond the window slides it forward
+    krlnc_sliding_window_encoder_retire_symbols(encoder, capacity);
+    EXPECT_EQ(capacity, krlnc_sliding_window_encoder_window_start(encoder));
+
+    krlnc_sliding_window_encoder_set_systematic_on(encoder);
+    for (uint32_t i = capacity; i < 2 * capacity; ++i)
+    {
+        EXPECT_TRUE(krlnc_sliding_window_encoder_push_symbol(
+            encoder, data_in.data() + i * symbol_size));
+
+        uint32_t bytes_used = krlnc_sliding_window_encoder_produce_payload(
+            encoder, payload.data());
+        krlnc_sliding_window_decoder_consume_payload(
+            decoder, payload.data(), bytes_used);
+    }
+
+    EXPECT_EQ(capacity, krlnc_sliding_window_decoder_window_start(decoder));
+    EXPECT_EQ(2 * capacity, krlnc_sliding_window_decoder_window_end(decoder));
+    EXPECT_FALSE(krlnc_sliding_window_decoder_is_symbol_decoded(
+        decoder, capacity - 1));
+    EXPECT_TRUE(krlnc_sliding_window_decoder_is_symbol_decoded(
+        decoder, capacity));
+
+    krlnc_delete_sliding_window_encoder(encoder);
+    krlnc_delete_sliding_window_decoder(decoder);
+}